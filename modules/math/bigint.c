@@ -31,28 +31,50 @@
 #ifdef _WIN32
 #define snprintf _snprintf
 #define strtoi64(a,b) _strtoi64(a,b,10)
-#define FMLTI64 "%I64d"
 #define MAX_INT64 LLONG_MAX
 #define LABS llabs
 
 #elif defined(__LP64__)||defined(_LP64)||defined(__ILP64__)||defined(_ILP64)
 #define strtoi64(a,b) strtol(a,b,10)
-#define FMLTI64 "%ld"
 #define MAX_INT64 LONG_MAX
 #define LABS labs
 #else
 
 #define strtoi64(a,b) strtoll(a,b,10)
-#define FMLTI64 "%lld"
 #define MAX_INT64 LLONG_MAX
 #define LABS llabs
 #endif
 
 #define BI_CONST  (1<<30)       /* Marker for a constant int64 number */
-#define BIVAL(r) (mactx->value[(size_t)(r)])
-#define BIRCNT(r) (mactx->refcnt[(size_t)(r)])
+#define BI_DECLEN 20            /* Max. length of an int64 in decimal */
+
+/* A reference to an int64 is either an immediate value or the number */
+/* of an entry of the pool:                                           */
+/*  - immediate (lowest bit set): the value is stored in the other    */
+/*    bits of the reference (values fitting in a pointer minus 1 bit) */
+/*  - pool entry: number n (page n>>BI_PGSHIFT, entry n&BI_PGMASK)    */
+/*    shifted by 1 bit. Number 0 is never used.                       */
+/* Immediates cannot be modified: they are used for the temporaries   */
+/* produced by operators and for constants. Entities are allocated in */
+/* the pool (bi_create) such that they can be modified in place.     */
+#define BI_ISIMM(r) (((size_t)(r))&1)
+#define BI_IMMVAL(r) ((int64_t)((intptr_t)(r)>>1))
+#define BI_IMMREF(v) ((void *)(((uintptr_t)(intptr_t)(v)<<1)|1))
+#define BI_IMMMIN ((int64_t)(INTPTR_MIN>>1))
+#define BI_IMMMAX ((int64_t)(INTPTR_MAX>>1))
+#define BINUM(r) ((size_t)(r)>>1)
+#define BIVAL(r) (mactx->page[BINUM(r)>>BI_PGSHIFT]->value[BINUM(r)&BI_PGMASK])
+#define BIRCNT(r) (mactx->page[BINUM(r)>>BI_PGSHIFT]->refcnt[BINUM(r)&BI_PGMASK])
 
 static int i64isneg(s_mathctx *mactx,void *r);
+static int64_t bi_value(s_mathctx *mactx,void *r);
+static void *bi_result(XPRMcontext ctx,s_mathctx *mactx,void *r,int64_t v);
+static int bi_fmtdec(char *buf,int64_t v);
+static uint32_t bi_parse8(const char *s);
+static int64_t bi_strtoi64(const char *str,char **endptr);
+static int bi_areduce(XPRMcontext ctx,void *libctx,int what);
+static int bi_newpage(XPRMcontext ctx,s_mathctx *mactx);
+static void bi_pgunlink(s_mathctx *mactx,int p);
 
 /******** Functions implementing the operators ********/
 
@@ -84,7 +106,7 @@ static int bi_isodd(XPRMcontext ctx,void *libctx)
  void *r1;
 
  r1=XPRM_POP_REF(ctx);
- XPRM_PUSH_INT(ctx,r1==NULL?0:BIVAL(r1)%2);
+ XPRM_PUSH_INT(ctx,bi_value(mactx,r1)%2);
  return XPRM_RT_OK;
 }
 
@@ -97,13 +119,11 @@ static int bi_abs(XPRMcontext ctx,void *libctx)
  void *r1,*r2;
 
  r1=XPRM_POP_REF(ctx);
- r2=bi_create(ctx,libctx,NULL,0);
+ r2=bi_result(ctx,mactx,NULL,LABS(bi_value(mactx,r1)));
  if(r2==NULL)
   return XPRM_RT_ERROR;
  else
  {
-  if(r1!=NULL)
-   BIVAL(r2)=LABS(BIVAL(r1));
   XPRM_PUSH_REF(ctx,r2);
   return XPRM_RT_OK;
  }
@@ -118,7 +138,7 @@ static int bi_asint(XPRMcontext ctx,void *libctx)
  void *r1;
 
  r1=XPRM_POP_REF(ctx);
- XPRM_PUSH_INT(ctx,r1==NULL?0:BIVAL(r1));
+ XPRM_PUSH_INT(ctx,bi_value(mactx,r1));
  return XPRM_RT_OK;
 }
 
@@ -131,7 +151,7 @@ static int bi_asreal(XPRMcontext ctx,void *libctx)
  void *r1;
 
  r1=XPRM_POP_REF(ctx);
- XPRM_PUSH_REAL(ctx,r1==NULL?0:BIVAL(r1));
+ XPRM_PUSH_REAL(ctx,bi_value(mactx,r1));
  return XPRM_RT_OK;
 }
 
@@ -146,9 +166,8 @@ static int bi_new0(XPRMcontext ctx,void *libctx)
  r1=XPRM_POP_REF(ctx);
  if(r1!=NULL)
  {
-  r2=bi_create(ctx,libctx,NULL,0);
+  r2=bi_result(ctx,mactx,NULL,bi_value(mactx,r1));
   if(r2==NULL) return XPRM_RT_ERROR;
-  BIVAL(r2)=BIVAL(r1);
   XPRM_PUSH_REF(ctx,r2);
  }
  else
@@ -164,9 +183,8 @@ static int bi_new1r(XPRMcontext ctx,void *libctx)
  s_mathctx *mactx=libctx;
  void *r1;
 
- r1=bi_create(ctx,libctx,NULL,0);
+ r1=bi_result(ctx,mactx,NULL,(int64_t)XPRM_POP_REAL(ctx));
  if(r1==NULL) return XPRM_RT_ERROR;
- BIVAL(r1)=(int64_t)XPRM_POP_REAL(ctx);
  XPRM_PUSH_REF(ctx,r1);
  return XPRM_RT_OK;
 }
@@ -179,9 +197,8 @@ static int bi_new1i(XPRMcontext ctx,void *libctx)
  s_mathctx *mactx=libctx;
  void *r1;
 
- r1=bi_create(ctx,libctx,NULL,0);
+ r1=bi_result(ctx,mactx,NULL,XPRM_POP_INT(ctx));
  if(r1==NULL) return XPRM_RT_ERROR;
- BIVAL(r1)=XPRM_POP_INT(ctx);
  XPRM_PUSH_REF(ctx,r1);
  return XPRM_RT_OK;
 }
@@ -241,7 +258,7 @@ static int bi_asgn(XPRMcontext ctx,void *libctx)
   return RT_ERROR;
  }
  else
- if(BIRCNT(r1)&BI_CONST)
+ if(BI_ISIMM(r1)||(BIRCNT(r1)&BI_CONST))
  {
   mm->dispmsg(ctx,"Math: Trying to modify a constant.\n");
   return RT_ERROR;
@@ -254,7 +271,7 @@ static int bi_asgn(XPRMcontext ctx,void *libctx)
  }
  else
  {
-  BIVAL(r1)=BIVAL(r2);
+  BIVAL(r1)=bi_value(mactx,r2);
   bi_delete(ctx,libctx,r2,0);
   return XPRM_RT_OK;
  }
@@ -275,7 +292,7 @@ static int bi_asgn_i(XPRMcontext ctx,void *libctx)
   return RT_ERROR;
  }
  else
- if(BIRCNT(r1)&BI_CONST)
+ if(BI_ISIMM(r1)||(BIRCNT(r1)&BI_CONST))
  {
   mm->dispmsg(ctx,"Math: Trying to modify a constant.\n");
   return RT_ERROR;
@@ -301,8 +318,9 @@ static int bi_pls(XPRMcontext ctx,void *libctx)
  {
   if(r2!=NULL)
   {
-   BIVAL(r1)+=BIVAL(r2);
+   r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)+bi_value(mactx,r2));
    bi_delete(ctx,libctx,r2,0);
+   if(r1==NULL) return XPRM_RT_ERROR;
   }
   XPRM_PUSH_REF(ctx,r1);
  }
@@ -322,7 +340,8 @@ static int bi_pls_i(XPRMcontext ctx,void *libctx)
  r1=XPRM_POP_REF(ctx);
  if(r1!=NULL)
  {
-  BIVAL(r1)+=XPRM_POP_INT(ctx);
+  r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)+XPRM_POP_INT(ctx));
+  if(r1==NULL) return XPRM_RT_ERROR;
   XPRM_PUSH_REF(ctx,r1);
   return XPRM_RT_OK;
  }
@@ -342,7 +361,7 @@ static int bi_pls_r(XPRMcontext ctx,void *libctx)
  r1=XPRM_POP_REF(ctx);
  if(r1!=NULL)
  {
-  d=XPRM_POP_REAL(ctx)+(double)BIVAL(r1);
+  d=XPRM_POP_REAL(ctx)+(double)bi_value(mactx,r1);
   bi_delete(ctx,libctx,r1,0);
   XPRM_PUSH_REAL(ctx,d);
   return XPRM_RT_OK;
@@ -361,7 +380,10 @@ static int bi_neg(XPRMcontext ctx,void *libctx)
 
  r1=XPRM_POP_REF(ctx);
  if(r1!=NULL)
-  BIVAL(r1)=-BIVAL(r1);
+ {
+  r1=bi_result(ctx,mactx,r1,-bi_value(mactx,r1));
+  if(r1==NULL) return XPRM_RT_ERROR;
+ }
  XPRM_PUSH_REF(ctx,r1);
  return XPRM_RT_OK;
 }
@@ -378,10 +400,12 @@ static int bi_mul(XPRMcontext ctx,void *libctx)
  r2=XPRM_POP_REF(ctx);
  if(r1!=NULL)
  {
-  if(r2!=NULL)
-   BIVAL(r1)*=BIVAL(r2);
-  else
-   BIVAL(r1)=0;
+  r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)*bi_value(mactx,r2));
+  if(r1==NULL)
+  {
+   bi_delete(ctx,libctx,r2,0);
+   return XPRM_RT_ERROR;
+  }
  }
  bi_delete(ctx,libctx,r2,0);
  XPRM_PUSH_REF(ctx,r1);
@@ -400,7 +424,10 @@ static int bi_mul_i(XPRMcontext ctx,void *libctx)
  r1=XPRM_POP_REF(ctx);
  i=XPRM_POP_INT(ctx);
  if(r1!=NULL)
-  BIVAL(r1)*=i;
+ {
+  r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)*i);
+  if(r1==NULL) return XPRM_RT_ERROR;
+ }
  XPRM_PUSH_REF(ctx,r1);
  return XPRM_RT_OK;
 }
@@ -418,7 +445,7 @@ static int bi_mul_r(XPRMcontext ctx,void *libctx)
  d=XPRM_POP_REAL(ctx);
  if(r1!=NULL)
  {
-  d*=(double)BIVAL(r1);
+  d*=(double)bi_value(mactx,r1);
   bi_delete(ctx,libctx,r1,0);
  }
  else
@@ -437,7 +464,7 @@ static int bi_div(XPRMcontext ctx,void *libctx)
 
  r1=XPRM_POP_REF(ctx);
  r2=XPRM_POP_REF(ctx);
- if((r2==NULL)||(BIVAL(r2)==0))
+ if((r2==NULL)||(bi_value(mactx,r2)==0))
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
   XPRM_PUSH_REAL(ctx,strtod(i64isneg(mactx,r1)?"-inf":"inf",NULL));
@@ -449,7 +476,7 @@ static int bi_div(XPRMcontext ctx,void *libctx)
  {
   if(r1!=NULL)
   {
-   XPRM_PUSH_REAL(ctx,(double)BIVAL(r1)/(double)BIVAL(r2));
+   XPRM_PUSH_REAL(ctx,(double)bi_value(mactx,r1)/(double)bi_value(mactx,r2));
    bi_delete(ctx,libctx,r1,0);
   }
   else
@@ -483,7 +510,7 @@ static int bi_div_i1(XPRMcontext ctx,void *libctx)
    XPRM_PUSH_REAL(ctx,0);
   else
   {
-   XPRM_PUSH_REAL(ctx,(double)BIVAL(r1)/i);
+   XPRM_PUSH_REAL(ctx,(double)bi_value(mactx,r1)/i);
    bi_delete(ctx,libctx,r1,0);
   }
   return XPRM_RT_OK;
@@ -501,7 +528,7 @@ static int bi_div_i2(XPRMcontext ctx,void *libctx)
 
  i=XPRM_POP_INT(ctx);
  r1=XPRM_POP_REF(ctx);
- if((r1==NULL)||(BIVAL(r1)==0))
+ if((r1==NULL)||(bi_value(mactx,r1)==0))
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
   XPRM_PUSH_REAL(ctx,strtod(i<0?"-inf":"inf",NULL));
@@ -510,7 +537,7 @@ static int bi_div_i2(XPRMcontext ctx,void *libctx)
  }
  else
  {
-  XPRM_PUSH_REAL(ctx,i/(double)BIVAL(r1));
+  XPRM_PUSH_REAL(ctx,i/(double)bi_value(mactx,r1));
   bi_delete(ctx,libctx,r1,0);
   return XPRM_RT_OK;
  }
@@ -540,7 +567,7 @@ static int bi_div_r1(XPRMcontext ctx,void *libctx)
    XPRM_PUSH_REAL(ctx,0);
   else
   {
-   XPRM_PUSH_REAL(ctx,(double)BIVAL(r1)/d);
+   XPRM_PUSH_REAL(ctx,(double)bi_value(mactx,r1)/d);
    bi_delete(ctx,libctx,r1,0);
   }
   return XPRM_RT_OK;
@@ -558,7 +585,7 @@ static int bi_div_r2(XPRMcontext ctx,void *libctx)
 
  d=XPRM_POP_REAL(ctx);
  r1=XPRM_POP_REF(ctx);
- if((r1==NULL)||(BIVAL(r1)==0))
+ if((r1==NULL)||(bi_value(mactx,r1)==0))
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
   XPRM_PUSH_REAL(ctx,strtod(d<0?"-inf":"inf",NULL));
@@ -567,7 +594,7 @@ static int bi_div_r2(XPRMcontext ctx,void *libctx)
  }
  else
  {
-  XPRM_PUSH_REAL(ctx,d/(double)BIVAL(r1));
+  XPRM_PUSH_REAL(ctx,d/(double)bi_value(mactx,r1));
   bi_delete(ctx,libctx,r1,0);
   return XPRM_RT_OK;
  }
@@ -583,15 +610,15 @@ static int bi_idiv(XPRMcontext ctx,void *libctx)
 
  r1=XPRM_POP_REF(ctx);
  r2=XPRM_POP_REF(ctx);
- if((r2==NULL)||(BIVAL(r2)==0))
+ if((r2==NULL)||(bi_value(mactx,r2)==0))
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
   bi_delete(ctx,libctx,r2,0);
-  if((r1==NULL)&&((r1=bi_create(ctx,libctx,NULL,0))==NULL))
+  r1=bi_result(ctx,mactx,r1,i64isneg(mactx,r1)?-MAX_INT64-1:MAX_INT64);
+  if(r1==NULL)
    return XPRM_RT_ERROR;
   else
   {
-   BIVAL(r1)=BIVAL(r1)<0?-MAX_INT64-1:MAX_INT64;
    XPRM_PUSH_REF(ctx,r1);
    return XPRM_RT_MATHERR;
   }
@@ -599,9 +626,10 @@ static int bi_idiv(XPRMcontext ctx,void *libctx)
  else
  {
   if(r1!=NULL)
-   BIVAL(r1)=BIVAL(r1)/BIVAL(r2);
-  XPRM_PUSH_REF(ctx,r1);
+   r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)/bi_value(mactx,r2));
   bi_delete(ctx,libctx,r2,0);
+  if(r1==NULL) return XPRM_RT_ERROR;
+  XPRM_PUSH_REF(ctx,r1);
   return XPRM_RT_OK;
  }
 }
@@ -620,19 +648,19 @@ static int bi_idiv_i1(XPRMcontext ctx,void *libctx)
  if(i==0)
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
-  if((r1==NULL)&&((r1=bi_create(ctx,libctx,NULL,0))==NULL))
+  r1=bi_result(ctx,mactx,r1,i64isneg(mactx,r1)?-MAX_INT64-1:MAX_INT64);
+  if(r1==NULL)
    return XPRM_RT_ERROR;
   else
   {
-   BIVAL(r1)=BIVAL(r1)<0?-MAX_INT64-1:MAX_INT64;
    XPRM_PUSH_REF(ctx,r1);
    return XPRM_RT_MATHERR;
   }
  }
  else
  {
-  if(r1!=NULL)
-   BIVAL(r1)/=i;
+  if((r1!=NULL)&&((r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)/i))==NULL))
+   return XPRM_RT_ERROR;
   XPRM_PUSH_REF(ctx,r1);
   return XPRM_RT_OK;
  }
@@ -649,7 +677,7 @@ static int bi_idiv_i2(XPRMcontext ctx,void *libctx)
 
  i=XPRM_POP_INT(ctx);
  r1=XPRM_POP_REF(ctx);
- if((r1==NULL)||(BIVAL(r1)==0))
+ if((r1==NULL)||(bi_value(mactx,r1)==0))
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
   XPRM_PUSH_INT(ctx,i<0?-INT_MAX-1:INT_MAX);
@@ -658,7 +686,7 @@ static int bi_idiv_i2(XPRMcontext ctx,void *libctx)
  }
  else
  {
-  XPRM_PUSH_INT(ctx,(int)(i/BIVAL(r1)));
+  XPRM_PUSH_INT(ctx,(int)(i/bi_value(mactx,r1)));
   bi_delete(ctx,libctx,r1,0);
   return XPRM_RT_OK;
  }
@@ -674,15 +702,15 @@ static int bi_mod(XPRMcontext ctx,void *libctx)
 
  r1=XPRM_POP_REF(ctx);
  r2=XPRM_POP_REF(ctx);
- if((r2==NULL)||(BIVAL(r2)==0))
+ if((r2==NULL)||(bi_value(mactx,r2)==0))
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
   bi_delete(ctx,libctx,r2,0);
-  if((r1==NULL)&&((r1=bi_create(ctx,libctx,NULL,0))==NULL))
+  r1=bi_result(ctx,mactx,r1,i64isneg(mactx,r1)?-MAX_INT64-1:MAX_INT64);
+  if(r1==NULL)
    return XPRM_RT_ERROR;
   else
   {
-   BIVAL(r1)=BIVAL(r1)<0?-MAX_INT64-1:MAX_INT64;
    XPRM_PUSH_REF(ctx,r1);
    return XPRM_RT_MATHERR;
   }
@@ -690,9 +718,10 @@ static int bi_mod(XPRMcontext ctx,void *libctx)
  else
  {
   if(r1!=NULL)
-   BIVAL(r1)=BIVAL(r1)%BIVAL(r2);
-  XPRM_PUSH_REF(ctx,r1);
+   r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)%bi_value(mactx,r2));
   bi_delete(ctx,libctx,r2,0);
+  if(r1==NULL) return XPRM_RT_ERROR;
+  XPRM_PUSH_REF(ctx,r1);
   return XPRM_RT_OK;
  }
 }
@@ -711,19 +740,19 @@ static int bi_mod_i1(XPRMcontext ctx,void *libctx)
  if(i==0)
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
-  if((r1==NULL)&&((r1=bi_create(ctx,libctx,NULL,0))==NULL))
+  r1=bi_result(ctx,mactx,r1,i64isneg(mactx,r1)?-MAX_INT64-1:MAX_INT64);
+  if(r1==NULL)
    return XPRM_RT_ERROR;
   else
   {
-   BIVAL(r1)=BIVAL(r1)<0?-MAX_INT64-1:MAX_INT64;
    XPRM_PUSH_REF(ctx,r1);
    return XPRM_RT_MATHERR;
   }
  }
  else
  {
-  if(r1!=NULL)
-   BIVAL(r1)%=i;
+  if((r1!=NULL)&&((r1=bi_result(ctx,mactx,r1,bi_value(mactx,r1)%i))==NULL))
+   return XPRM_RT_ERROR;
   XPRM_PUSH_REF(ctx,r1);
   return XPRM_RT_OK;
  }
@@ -740,7 +769,7 @@ static int bi_mod_i2(XPRMcontext ctx,void *libctx)
 
  i=XPRM_POP_INT(ctx);
  r1=XPRM_POP_REF(ctx);
- if((r1==NULL)||(BIVAL(r1)==0))
+ if((r1==NULL)||(bi_value(mactx,r1)==0))
  {
   mm->dispmsg(ctx,"Math: Division by 0.\n");
   XPRM_PUSH_INT(ctx,i<0?-INT_MAX-1:INT_MAX);
@@ -749,7 +778,7 @@ static int bi_mod_i2(XPRMcontext ctx,void *libctx)
  }
  else
  {
-  XPRM_PUSH_INT(ctx,(int)(i % BIVAL(r1)));
+  XPRM_PUSH_INT(ctx,(int)(i % bi_value(mactx,r1)));
   bi_delete(ctx,libctx,r1,0);
   return XPRM_RT_OK;
  }
@@ -768,7 +797,7 @@ static int bi_eql_i(XPRMcontext ctx,void *libctx)
  r1=XPRM_POP_REF(ctx);
  i=XPRM_POP_INT(ctx);
  if(r1!=NULL)
-  b=BIVAL(r1)==i;
+  b=bi_value(mactx,r1)==i;
  else
   b=(0==i);
  XPRM_PUSH_INT(ctx,b);
@@ -788,7 +817,7 @@ static int bi_eql_i2(XPRMcontext ctx,void *libctx)
  i=XPRM_POP_INT(ctx);
  r1=XPRM_POP_REF(ctx);
  if(r1!=NULL)
-  b=BIVAL(r1)==i;
+  b=bi_value(mactx,r1)==i;
  else
   b=(0==i);
  XPRM_PUSH_INT(ctx,b);
@@ -808,7 +837,7 @@ static int bi_lt_i(XPRMcontext ctx,void *libctx)
  r1=XPRM_POP_REF(ctx);
  i=XPRM_POP_INT(ctx);
  if(r1!=NULL)
-  b=BIVAL(r1)<i;
+  b=bi_value(mactx,r1)<i;
  else
   b=(0<i);
  XPRM_PUSH_INT(ctx,b);
@@ -828,7 +857,7 @@ static int bi_lt_i2(XPRMcontext ctx,void *libctx)
  i=XPRM_POP_INT(ctx);
  r1=XPRM_POP_REF(ctx);
  if(r1!=NULL)
-  b=BIVAL(r1)>i;
+  b=bi_value(mactx,r1)>i;
  else
   b=(0>i);
  XPRM_PUSH_INT(ctx,b);
@@ -848,7 +877,7 @@ static int bi_gt_i(XPRMcontext ctx,void *libctx)
  r1=XPRM_POP_REF(ctx);
  i=XPRM_POP_INT(ctx);
  if(r1!=NULL)
-  b=BIVAL(r1)>i;
+  b=bi_value(mactx,r1)>i;
  else
   b=(0>i);
  XPRM_PUSH_INT(ctx,b);
@@ -868,78 +897,169 @@ static int bi_gt_i2(XPRMcontext ctx,void *libctx)
  i=XPRM_POP_INT(ctx);
  r1=XPRM_POP_REF(ctx);
  if(r1!=NULL)
-  b=BIVAL(r1)<i;
+  b=bi_value(mactx,r1)<i;
  else
   b=(0<i);
  XPRM_PUSH_INT(ctx,b);
  return XPRM_RT_OK;
 }
 
+/******** Reductions over arrays of int64 ********/
+
+/* The values are accumulated in a single pass over the array: sums */
+/* and products wrap around like the operators.                     */
+
+/*************************************/
+/* Common routine for sum, min & max */
+/*************************************/
+static int bi_areduce(XPRMcontext ctx,void *libctx,int what)
+{
+ s_mathctx *mactx=libctx;
+ XPRMarray arr;
+ XPRMalltypes v;
+ int64_t x,res;
+ uint64_t sum;
+ void *r;
+ int indices[15];
+ int done;
+
+ arr=XPRM_POP_REF(ctx);
+ res=(what==0)?0:((what<0)?MAX_INT64:-MAX_INT64-1);
+ sum=0;
+ if((arr!=NULL)&&(mm->getarrdim(arr)>15))
+ {
+  mm->dispmsg(ctx,"Math: Invalid array.\n");
+  return XPRM_RT_ERROR;
+ }
+ done=(arr==NULL)||mm->getfirstarrtruentry(arr,indices);
+ while(!done)
+ {
+  v.ref=NULL;
+  mm->getarrval(arr,indices,&v);
+  x=bi_value(mactx,v.ref);
+  if(what==0)
+   sum+=(uint64_t)x;
+  else
+  if((what<0)?(x<res):(x>res))
+   res=x;
+  done=mm->getnextarrtruentry(arr,indices);
+ }
+ if(what==0)
+  res=(int64_t)sum;
+ if((r=bi_result(ctx,mactx,NULL,res))==NULL)
+  return XPRM_RT_ERROR;
+ XPRM_PUSH_REF(ctx,r);
+ return XPRM_RT_OK;
+}
+
+/***************************/
+/* sum_i64(array of int64) */
+/***************************/
+static int bi_asum(XPRMcontext ctx,void *libctx)
+{
+ return bi_areduce(ctx,libctx,0);
+}
+
+/***************************/
+/* min_i64(array of int64) */
+/***************************/
+static int bi_amin(XPRMcontext ctx,void *libctx)
+{
+ return bi_areduce(ctx,libctx,-1);
+}
+
+/***************************/
+/* max_i64(array of int64) */
+/***************************/
+static int bi_amax(XPRMcontext ctx,void *libctx)
+{
+ return bi_areduce(ctx,libctx,1);
+}
+
+/******************************************************/
+/* dot_i64(array of int64,array of int64): the arrays */
+/* have identical indexing sets (entries of the first */
+/* array missing in the second one count as 0)        */
+/******************************************************/
+static int bi_adot(XPRMcontext ctx,void *libctx)
+{
+ s_mathctx *mactx=libctx;
+ XPRMarray arr1,arr2;
+ XPRMalltypes v1,v2;
+ uint64_t sum;
+ void *r;
+ int indices[15];
+ int done;
+
+ arr1=XPRM_POP_REF(ctx);
+ arr2=XPRM_POP_REF(ctx);
+ sum=0;
+ if((arr1!=NULL)&&(arr2!=NULL))
+ {
+  if(!samesets(ctx,arr1,arr2))
+  {
+   mm->dispmsg(ctx,"Math: Incompatible arrays for `dot_i64'.\n");
+   return XPRM_RT_ERROR;
+  }
+  done=mm->getfirstarrtruentry(arr1,indices);
+  while(!done)
+  {
+   v1.ref=v2.ref=NULL;
+   mm->getarrval(arr1,indices,&v1);
+   mm->getarrval(arr2,indices,&v2);
+   sum+=(uint64_t)bi_value(mactx,v1.ref)*(uint64_t)bi_value(mactx,v2.ref);
+   done=mm->getnextarrtruentry(arr1,indices);
+  }
+ }
+ if((r=bi_result(ctx,mactx,NULL,(int64_t)sum))==NULL)
+  return XPRM_RT_ERROR;
+ XPRM_PUSH_REF(ctx,r);
+ return XPRM_RT_OK;
+}
+
 /****************************/
 /* Allocate an int64 number */
 /****************************/
+/* Entries are taken from the first page of the list of pages having */
+/* free entries: pages are never moved such that references remain   */
+/* valid when the pool grows.                                        */
 static void *bi_create(XPRMcontext ctx,void *libctx,void *todup,int typnum)
 {
  s_mathctx *mactx=libctx;
+ s_bipage *pg;
  size_t newi;
+ int off;
 
  if((todup!=NULL)&&(XPRM_CREATE(typnum)==XPRM_CREATE_NEW))
  {
-  BIRCNT(todup)++;
+  if(!BI_ISIMM(todup))
+   BIRCNT(todup)++;
   return todup;
  }
  else
+ if((XPRM_CREATE(typnum)==XPRM_CREATE_CST)&&
+    (BI_ISIMM(todup)||((bi_value(mactx,todup)>=BI_IMMMIN)&&
+                       (bi_value(mactx,todup)<=BI_IMMMAX))))
+  return BI_IMMREF(bi_value(mactx,todup));
+ else
  {
-  if(mactx->nbmaxi64>mactx->nbi64)
+  if((mactx->pgfree<0)&&bi_newpage(ctx,mactx))
+   return NULL;
+  pg=mactx->page[mactx->pgfree];
+  if(pg->firstfree>=0)
   {
-   if(mactx->firstfree!=0)
-   {
-    newi=mactx->firstfree;
-    mactx->firstfree=(size_t)BIVAL(newi);
-   }
-   else
-    newi=mactx->nbi64;
+   off=pg->firstfree;
+   pg->firstfree=(int)pg->value[off];
   }
   else
-  {
-   int newnbm;
-   int64_t *newv;
-
-   if(mactx->nbmaxi64==0)
-    newnbm=340;
-   else
-   if(mactx->nbmaxi64<10000)
-    newnbm=mactx->nbmaxi64*2;
-   else
-    newnbm=mactx->nbmaxi64+10000;
-   newv=realloc(mactx->value,newnbm*(sizeof(int)+sizeof(int64_t)));
-   if(newv==NULL)
-   {
-    mm->dispmsg(ctx,"Math: Out of memory error.\n");
-    return NULL;
-   }
-   else
-   {
-    mactx->value=newv;
-    mactx->refcnt=(unsigned int*)(newv+newnbm);
-    if(mactx->nbi64==0) /* the first entry is not used */
-    {
-     BIVAL(0)=0;
-     BIRCNT(0)=0;
-     newi=mactx->nbi64=1;
-    }
-    else
-    {
-     memmove(mactx->refcnt,mactx->value+mactx->nbmaxi64,mactx->nbmaxi64*sizeof(int));
-     newi=mactx->nbi64;
-    }
-    mactx->nbmaxi64=newnbm;
-   }
-  }
+   off=pg->nbinit++;
+  newi=(((size_t)mactx->pgfree<<BI_PGSHIFT)|off)<<1;
+  if(++pg->nbused>=BI_PGSIZE)    /* the page is now full */
+   bi_pgunlink(mactx,mactx->pgfree);
   mactx->nbi64++;
   if(XPRM_CREATE(typnum)==XPRM_CREATE_CST)
   {
-   BIVAL(newi)=BIVAL(todup);
+   BIVAL(newi)=bi_value(mactx,todup);
    BIRCNT(newi)=1|BI_CONST;
   }
   else
@@ -954,19 +1074,135 @@ static void *bi_create(XPRMcontext ctx,void *libctx,void *todup,int typnum)
 /******************************/
 /* Deallocate an int64 number */
 /******************************/
+/* A page becoming empty is released: the last one is kept for reuse */
 static void bi_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum)
 {
  s_mathctx *mactx=libctx;
+ s_bipage *pg;
+ int p,off;
 
- if((todel!=NULL)&&(((--BIRCNT(todel))&~BI_CONST)<1))
+ if((todel!=NULL)&&!BI_ISIMM(todel)&&(((--BIRCNT(todel))&~BI_CONST)<1))
  {
-  BIRCNT(todel)=0;
-  BIVAL(todel)=(int64_t)(mactx->firstfree);
-  mactx->firstfree=(size_t)todel;
+  p=(int)(BINUM(todel)>>BI_PGSHIFT);
+  off=(int)(BINUM(todel)&BI_PGMASK);
+  pg=mactx->page[p];
+  pg->refcnt[off]=0;
+  pg->value[off]=pg->firstfree;
+  pg->firstfree=off;
   mactx->nbi64--;
+  if(pg->nbused--==BI_PGSIZE)    /* the page was full */
+  {
+   pg->prev=-1;
+   pg->next=mactx->pgfree;
+   if(mactx->pgfree>=0)
+    mactx->page[mactx->pgfree]->prev=p;
+   mactx->pgfree=p;
+  }
+  else
+  if(pg->nbused==0)
+  {
+   bi_pgunlink(mactx,p);
+   mactx->page[p]=NULL;
+   if(mactx->spare==NULL)
+    mactx->spare=pg;
+   else
+   {
+    free(pg);
+    mactx->nbpgalloc--;
+   }
+  }
  }
 }
 
+/***************************************************/
+/* Add a page at the beginning of the list of pages */
+/* having free entries                              */
+/***************************************************/
+static int bi_newpage(XPRMcontext ctx,s_mathctx *mactx)
+{
+ s_bipage *pg;
+ int p;
+
+ for(p=0;(p<mactx->nbpages)&&(mactx->page[p]!=NULL);p++);
+ if(p>=mactx->nbpages)          /* the page table is full */
+ {
+  s_bipage **newpt;
+  int newnbp;
+
+  newnbp=(mactx->nbpages==0)?16:mactx->nbpages*2;
+  if(newnbp>(INT_MAX>>BI_PGSHIFT)+1) /* 'nbi64' must not overflow */
+   newpt=NULL;
+  else
+   newpt=realloc(mactx->page,newnbp*sizeof(s_bipage *));
+  if(newpt==NULL)
+  {
+   mm->dispmsg(ctx,"Math: Out of memory error.\n");
+   return 1;
+  }
+  memset(newpt+mactx->nbpages,0,(newnbp-mactx->nbpages)*sizeof(s_bipage *));
+  mactx->page=newpt;
+  mactx->nbpages=newnbp;
+ }
+ if(mactx->spare!=NULL)
+ {
+  pg=mactx->spare;
+  mactx->spare=NULL;
+ }
+ else
+ if((pg=malloc(sizeof(s_bipage)))==NULL)
+ {
+  mm->dispmsg(ctx,"Math: Out of memory error.\n");
+  return 1;
+ }
+ else
+  mactx->nbpgalloc++;
+ pg->nbused=pg->nbinit=0;
+ pg->firstfree=-1;
+ if(p==0)                       /* the first entry is not used */
+ {
+  pg->value[0]=0;
+  pg->refcnt[0]=0;
+  pg->nbused=pg->nbinit=1;
+ }
+ pg->prev=-1;
+ pg->next=mactx->pgfree;
+ if(mactx->pgfree>=0)
+  mactx->page[mactx->pgfree]->prev=p;
+ mactx->pgfree=p;
+ mactx->page[p]=pg;
+ return 0;
+}
+
+/************************************************/
+/* Remove a page from the list of pages having  */
+/* free entries                                 */
+/************************************************/
+static void bi_pgunlink(s_mathctx *mactx,int p)
+{
+ s_bipage *pg;
+
+ pg=mactx->page[p];
+ if(pg->prev>=0)
+  mactx->page[pg->prev]->next=pg->next;
+ else
+  mactx->pgfree=pg->next;
+ if(pg->next>=0)
+  mactx->page[pg->next]->prev=pg->prev;
+}
+
+/*******************************/
+/* Release all pages of int64s */
+/*******************************/
+static void bi_freeall(s_mathctx *mactx)
+{
+ int p;
+
+ for(p=0;p<mactx->nbpages;p++)
+  free(mactx->page[p]);
+ free(mactx->page);
+ free(mactx->spare);
+}
+
 /*******************/
 /* int64 -> String */
 /*******************/
@@ -978,13 +1214,11 @@ static int bi_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,int len,i
  {
   if(len>=sizeof(int64_t))
   {
-   if(toprt==NULL)
-    memset(str,0,sizeof(int64_t));
-   else
-   {
-    /* We assume that all supported platforms are little endian */
-    memcpy(str,&BIVAL(toprt),sizeof(int64_t));
-   }
+   int64_t v;
+
+   /* We assume that all supported platforms are little endian */
+   v=bi_value(mactx,toprt);
+   memcpy(str,&v,sizeof(int64_t));
   }
   return sizeof(int64_t);
  }
@@ -995,7 +1229,21 @@ static int bi_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,int len,i
   return 1;
  }
  else
-  return snprintf(str,len,FMLTI64,BIVAL(toprt));
+ {
+  char buf[BI_DECLEN+1];
+  int l;
+
+  l=bi_fmtdec(buf,bi_value(mactx,toprt));
+  if(len>l)
+   memcpy(str,buf,l+1);
+  else
+  if(len>0)
+  {
+   memcpy(str,buf,len-1);
+   str[len-1]='\0';
+  }
+  return l;
+ }
 }
 
 /*******************/
@@ -1005,7 +1253,7 @@ static int bi_fromstr(XPRMcontext ctx,void *libctx,void *toinit,const char *str,
 {
  s_mathctx *mactx=libctx;
 
- if(BIRCNT(toinit)&BI_CONST)
+ if(BI_ISIMM(toinit)||(BIRCNT(toinit)&BI_CONST))
  {
   mm->dispmsg(ctx,"Math: Trying to modify a constant.\n");
   return XPRM_RT_ERROR;
@@ -1026,7 +1274,7 @@ static int bi_fromstr(XPRMcontext ctx,void *libctx,void *toinit,const char *str,
  {
   char *ep;
 
-  BIVAL(toinit)=strtoi64(str,&ep);
+  BIVAL(toinit)=bi_strtoi64(str,&ep);
   if(endptr!=NULL) *endptr=ep;
   if((ep==str)|| !isdigit(ep[-1]))
    return XPRM_RT_ERROR;
@@ -1046,27 +1294,32 @@ static int bi_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,int typnu
  {
   case XPRM_CPY_COPY:
   case XPRM_CPY_RESET:
-      if(BIRCNT(toinit)&BI_CONST)
+      if(BI_ISIMM(toinit)||(BIRCNT(toinit)&BI_CONST))
        return 1;
       else
       {
-       BIVAL(toinit)=(src!=NULL)?BIVAL(src):0;
+       BIVAL(toinit)=bi_value(mactx,src);
        return 0;
       }
-  case XPRM_CPY_APPEND:
-      if(src!=NULL)
-       BIVAL(toinit)+=BIVAL(src);
-      return 0;
-  case XPRM_CPY_HASH:
+  case XPRM_CPY_APPEND:         /* x+=y: updated in place */
+      if(BI_ISIMM(toinit)||(BIRCNT(toinit)&BI_CONST))
+       return 1;
+      else
       {
-       if(src==NULL)
-       {
-        int64_t z=0;
-
-        *(unsigned int *)toinit=mm->hashmix(ctx,0,&z,sizeof(int64_t));
-       }
-       else
-        *(unsigned int *)toinit=mm->hashmix(ctx,0,&BIVAL(src),sizeof(int64_t));
+       BIVAL(toinit)+=bi_value(mactx,src);
+       return 0;
+      }
+  case XPRM_CPY_HASH:           /* multiply-xorshift mix (MurmurHash3) */
+      {
+       uint64_t v;
+
+       v=(uint64_t)bi_value(mactx,src);
+       v^=v>>33;
+       v*=0xff51afd7ed558ccdULL;
+       v^=v>>33;
+       v*=0xc4ceb9fe1a85ec53ULL;
+       v^=v>>33;
+       *(unsigned int *)toinit=(unsigned int)v;
        return 0;
       }
   default:
@@ -1082,9 +1335,14 @@ static int bi_compare(XPRMcontext ctx,void *libctx,void *r1,void *r2,int typnum)
  s_mathctx *mactx=libctx;
  int64_t i1,i2;
 
- i1=(r1==NULL)?0:BIVAL(r1);
- i2=(r2==NULL)?0:BIVAL(r2);
- 
+ if(r1==r2)                     /* same reference (or same immediate) */
+  i1=i2=0;
+ else
+ {
+  i1=bi_value(mactx,r1);
+  i2=bi_value(mactx,r2);
+ }
+
  switch(XPRM_COMPARE(typnum))
  {
   case XPRM_COMPARE_EQ: return i1==i2;
@@ -1108,10 +1366,7 @@ static int bi_compare(XPRMcontext ctx,void *libctx,void *r1,void *r2,int typnum)
 /************************************/
 static int64_t imci_getint64val(XPRMcontext ctx,s_mathctx *mactx,void *ref)
 {
- if(ref==NULL)
-  return 0;
- else
-  return BIVAL(ref);
+ return bi_value(mactx,ref);
 }
 
 /*******************************/
@@ -1122,7 +1377,7 @@ static int imci_setint64val(XPRMcontext ctx,s_mathctx *mactx,void *ref,int64_t v
  if(ref==NULL)
   return 1;
  else
- if(BIRCNT(ref)&BI_CONST)
+ if(BI_ISIMM(ref)||(BIRCNT(ref)&BI_CONST))
   return 2;
  else
  {
@@ -1131,10 +1386,225 @@ static int imci_setint64val(XPRMcontext ctx,s_mathctx *mactx,void *ref,int64_t v
  }
 }
 
+/****************************************/
+/* IMCI: retrieve the values of n int64 */
+/****************************************/
+static int imci_getint64vec(XPRMcontext ctx,s_mathctx *mactx,void **refs,int n,int64_t *v)
+{
+ int i;
+
+ for(i=0;i<n;i++)
+  v[i]=bi_value(mactx,refs[i]);
+ return 0;
+}
+
+/**************************************************/
+/* IMCI: set the values of n int64                */
+/* Returns the number of references not modified */
+/**************************************************/
+static int imci_setint64vec(XPRMcontext ctx,s_mathctx *mactx,void **refs,int n,const int64_t *v)
+{
+ int i,nbf;
+
+ nbf=0;
+ for(i=0;i<n;i++)
+  if((refs[i]==NULL)||BI_ISIMM(refs[i])||(BIRCNT(refs[i])&BI_CONST))
+   nbf++;
+  else
+   BIVAL(refs[i])=v[i];
+ return nbf;
+}
+
+/**********************************************************/
+/* IMCI: create n int64 (initialised with v if not NULL)  */
+/* The entries are taken page by page from the pool. In   */
+/* case of failure no entry is created (returns 1).       */
+/**********************************************************/
+static int imci_newint64vec(XPRMcontext ctx,s_mathctx *mactx,void **refs,int n,const int64_t *v)
+{
+ s_bipage *pg;
+ int i,p,off;
+
+ i=0;
+ while(i<n)
+ {
+  if((mactx->pgfree<0)&&bi_newpage(ctx,mactx))
+  {
+   while(i>0)
+    bi_delete(ctx,mactx,refs[--i],0);
+   return 1;
+  }
+  p=mactx->pgfree;
+  pg=mactx->page[p];
+  for(;(i<n)&&(pg->nbused<BI_PGSIZE);i++)
+  {
+   if(pg->firstfree>=0)
+   {
+    off=pg->firstfree;
+    pg->firstfree=(int)pg->value[off];
+   }
+   else
+    off=pg->nbinit++;
+   pg->value[off]=(v!=NULL)?v[i]:0;
+   pg->refcnt[off]=1;
+   pg->nbused++;
+   mactx->nbi64++;
+   refs[i]=(void *)((((size_t)p<<BI_PGSHIFT)|off)<<1);
+  }
+  if(pg->nbused>=BI_PGSIZE)     /* the page is now full */
+   bi_pgunlink(mactx,p);
+ }
+ return 0;
+}
+
 /**************************************/
 /* Check whether an int64 is negative */
 /**************************************/
 static int i64isneg(s_mathctx *mactx,void *r)
 {
- return (r!=NULL)&&(BIVAL(r)<0);
+ return bi_value(mactx,r)<0;
+}
+
+/******************************/
+/* Get the value of an int64  */
+/******************************/
+static int64_t bi_value(s_mathctx *mactx,void *r)
+{
+ if(r==NULL)
+  return 0;
+ else
+ if(BI_ISIMM(r))
+  return BI_IMMVAL(r);
+ else
+  return BIVAL(r);
+}
+
+/*************************************************************/
+/* Reference for the result v of an operation: an immediate  */
+/* if possible, otherwise the temporary r (if it is an entry */
+/* of the pool) or a new entry. The temporary r is released  */
+/* when it is not used for the result.                       */
+/*************************************************************/
+static void *bi_result(XPRMcontext ctx,s_mathctx *mactx,void *r,int64_t v)
+{
+ if((v>=BI_IMMMIN)&&(v<=BI_IMMMAX))
+ {
+  bi_delete(ctx,mactx,r,0);
+  return BI_IMMREF(v);
+ }
+ else
+ {
+  if((r==NULL)||BI_ISIMM(r))
+  {
+   r=bi_create(ctx,mactx,NULL,0);
+   if(r==NULL) return NULL;
+  }
+  BIVAL(r)=v;
+  return r;
+ }
+}
+
+/******** Decimal conversions ********/
+
+/* Pairs of digits "00" to "99" */
+static const char bi_digits[201]=
+ "0001020304050607080910111213141516171819"
+ "2021222324252627282930313233343536373839"
+ "4041424344454647484950515253545556575859"
+ "6061626364656667686970717273747576777879"
+ "8081828384858687888990919293949596979899";
+
+/**************************************************/
+/* Decimal representation of v: the digits are    */
+/* produced by pairs (buf has BI_DECLEN+1 chars). */
+/* Returns the length of the string.              */
+/**************************************************/
+static int bi_fmtdec(char *buf,int64_t v)
+{
+ char tmp[BI_DECLEN];
+ uint64_t u;
+ unsigned int k;
+ char *p;
+ int l;
+
+ u=(v<0)?(uint64_t)0-(uint64_t)v:(uint64_t)v;
+ p=tmp+BI_DECLEN;
+ while(u>=100)
+ {
+  k=(unsigned int)(u%100)*2;
+  u/=100;
+  p-=2;
+  memcpy(p,bi_digits+k,2);
+ }
+ if(u>=10)
+ {
+  p-=2;
+  memcpy(p,bi_digits+u*2,2);
+ }
+ else
+  *(--p)=(char)('0'+u);
+ if(v<0)
+  *(--p)='-';
+ l=(int)(tmp+BI_DECLEN-p);
+ memcpy(buf,p,l);
+ buf[l]='\0';
+ return l;
+}
+
+/*********************************************************/
+/* Value of 8 decimal digits: the 8 characters are read  */
+/* as a single 64-bit word and combined by pairs, then   */
+/* by groups of 4 (little endian byte order assumed)     */
+/*********************************************************/
+static uint32_t bi_parse8(const char *s)
+{
+ uint64_t x;
+
+ memcpy(&x,s,sizeof(uint64_t));
+ x-=0x3030303030303030ULL;
+ x=(x*10)+(x>>8);               /* 2-digit values in bytes 0,2,4,6 */
+ x=(((x&0x000000FF000000FFULL)*(100+(1000000ULL<<32)))+
+    (((x>>16)&0x000000FF000000FFULL)*(1+(10000ULL<<32))))>>32;
+ return (uint32_t)x;
+}
+
+/************************************************************/
+/* Read a decimal int64 (same behaviour as strtoll base 10) */
+/* Numbers out of range (or of more than 19 digits) are     */
+/* handled by the C library.                                */
+/************************************************************/
+static int64_t bi_strtoi64(const char *str,char **endptr)
+{
+ const char *s,*e;
+ uint64_t v;
+ int neg,nd;
+
+ s=str;
+ while(isspace((unsigned char)*s))
+  s++;
+ neg=(*s=='-');
+ if((*s=='-')||(*s=='+'))
+  s++;
+ for(nd=0;isdigit((unsigned char)s[nd]);nd++);
+ if(nd==0)
+ {
+  *endptr=(char *)str;
+  return 0;
+ }
+ else
+ if(nd>19)
+  return strtoi64(str,endptr);
+ else
+ {
+  e=s+nd;
+  v=0;                          /* 19 digits fit in a uint64 */
+  for(;nd>=8;nd-=8,s+=8)
+   v=v*100000000+bi_parse8(s);
+  for(;nd>0;nd--)
+   v=v*10+(uint64_t)(*(s++)-'0');
+  if(v>(uint64_t)INT64_MAX+neg)
+   return strtoi64(str,endptr);
+  *endptr=(char *)e;
+  return neg?(int64_t)((uint64_t)0-v):(int64_t)v;
+ }
 }
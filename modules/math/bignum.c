@@ -0,0 +1,1292 @@
+/******************************************
+  File bignum.c
+  `````````````
+  Example module defining a new type
+    bigint
+  (arbitrary precision integers)
+  with the corresponding arithmetic operators.
+
+  (c) Copyright 2026 Fair Isaac Corporation
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+*******************************************/
+/*  to be included in 'math.c' (after 'bigint.c') */
+
+/* A bigint is a sign and a vector of 32-bit limbs (least significant */
+/* first) without leading zero limbs: 0 has no limb and is positive.  */
+/* The reference NULL is also 0.                                      */
+
+#define BN_KARATSUBA 40         /* Limbs from which Karatsuba is used */
+#define BN_DEC 1000000000U      /* Base for decimal conversions */
+#define BN_DECDIG 9             /* Number of digits of BN_DEC-1 */
+
+static int bn_cmpmag(const uint32_t *a,int na,const uint32_t *b,int nb);
+static int bn_addmag(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb);
+static int bn_submag(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb);
+static void bn_mulbase(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb);
+static void bn_mulrec(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb,uint32_t *w);
+static uint32_t bn_divmod1(uint32_t *q,const uint32_t *a,int na,uint32_t d);
+static void bn_divmodn(uint32_t *q,uint32_t *rem,const uint32_t *u,int m,
+                const uint32_t *v,int n,uint32_t *w);
+static s_bigint *bn_alloc(XPRMcontext ctx);
+static int bn_reserve(XPRMcontext ctx,s_bigint *b,int n);
+static void bn_tmp64(s_bigint *t,uint32_t *d,int64_t v);
+static int bn_set(XPRMcontext ctx,s_bigint *r,const s_bigint *b);
+static int bn_addto(XPRMcontext ctx,s_bigint *r,const s_bigint *b,int neg);
+static int bn_mulby(XPRMcontext ctx,s_bigint *r,const s_bigint *b);
+static int bn_divby(XPRMcontext ctx,s_bigint *r,const s_bigint *b,int mod);
+static int bn_toint64(const s_bigint *b,int64_t *v);
+static char *bn_todec(XPRMcontext ctx,const s_bigint *b,int *len);
+static int bn_fromdec(XPRMcontext ctx,s_bigint *b,const char *str,
+                const char **endptr);
+
+/******** Limb vectors ********/
+
+/***************************************/
+/* Compare magnitudes: returns -1,0,1  */
+/***************************************/
+static int bn_cmpmag(const uint32_t *a,int na,const uint32_t *b,int nb)
+{
+ int i;
+
+ if(na!=nb)
+  return (na<nb)?-1:1;
+ for(i=na-1;i>=0;i--)
+  if(a[i]!=b[i])
+   return (a[i]<b[i])?-1:1;
+ return 0;
+}
+
+/******************************************************/
+/* r=a+b (r has max(na,nb)+1 limbs and may alias a/b) */
+/* returns the number of limbs of the result          */
+/******************************************************/
+static int bn_addmag(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb)
+{
+ uint64_t c;
+ int i;
+
+ if(na<nb)
+ {
+  const uint32_t *t=a;
+
+  a=b; b=t;
+  i=na; na=nb; nb=i;
+ }
+ c=0;
+ for(i=0;i<nb;i++)
+ {
+  c+=(uint64_t)a[i]+b[i];
+  r[i]=(uint32_t)c;
+  c>>=32;
+ }
+ for(;i<na;i++)
+ {
+  c+=a[i];
+  r[i]=(uint32_t)c;
+  c>>=32;
+ }
+ if(c)
+  r[na++]=(uint32_t)c;
+ return na;
+}
+
+/********************************************************/
+/* r=a-b with |a|>=|b| (r has na limbs, may alias a/b)  */
+/* returns the number of limbs of the result            */
+/********************************************************/
+static int bn_submag(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb)
+{
+ uint64_t t;
+ uint32_t br;
+ int i;
+
+ br=0;
+ for(i=0;i<nb;i++)
+ {
+  t=(uint64_t)a[i]-b[i]-br;
+  r[i]=(uint32_t)t;
+  br=(uint32_t)(t>>63);
+ }
+ for(;i<na;i++)
+ {
+  t=(uint64_t)a[i]-br;
+  r[i]=(uint32_t)t;
+  br=(uint32_t)(t>>63);
+ }
+ while((na>0)&&(r[na-1]==0))
+  na--;
+ return na;
+}
+
+/**************************************************/
+/* r=a*b (schoolbook): r has na+nb limbs and must */
+/* not overlap a or b                             */
+/**************************************************/
+static void bn_mulbase(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb)
+{
+ uint64_t c;
+ int i,j;
+
+ memset(r,0,(na+nb)*sizeof(uint32_t));
+ for(i=0;i<na;i++)
+ {
+  c=0;
+  for(j=0;j<nb;j++)
+  {
+   c+=(uint64_t)a[i]*b[j]+r[i+j];
+   r[i+j]=(uint32_t)c;
+   c>>=32;
+  }
+  r[i+nb]=(uint32_t)c;
+ }
+}
+
+/*****************************************************************/
+/* r=a*b: r has na+nb limbs and must not overlap a or b. Above   */
+/* BN_KARATSUBA limbs the Karatsuba method is applied; unbalanced */
+/* operands are cut into pieces of the size of the smaller one.  */
+/* w is a work area of 4*(na+nb)+64 limbs.                       */
+/*****************************************************************/
+static void bn_mulrec(uint32_t *r,const uint32_t *a,int na,
+                const uint32_t *b,int nb,uint32_t *w)
+{
+ uint32_t *sa,*sb,*z1;
+ int m,nsa,nsb,nz1,i;
+
+ if(na<nb)
+ {
+  const uint32_t *t=a;
+
+  a=b; b=t;
+  i=na; na=nb; nb=i;
+ }
+ if(nb<BN_KARATSUBA)
+  bn_mulbase(r,a,na,b,nb);
+ else
+ {
+  m=(na+1)/2;
+  if(nb<=m)                     /* unbalanced: pieces of nb limbs */
+  {
+   memset(r,0,(na+nb)*sizeof(uint32_t));
+   for(i=0;i<na;i+=nb)
+   {
+    m=(na-i<nb)?na-i:nb;
+    bn_mulrec(w,a+i,m,b,nb,w+m+nb);
+    bn_addmag(r+i,r+i,na+nb-i,w,m+nb);
+   }
+  }
+  else
+  {                             /* a=a1.B^m+a0  b=b1.B^m+b0 */
+   bn_mulrec(r,a,m,b,m,w);              /* z0=a0*b0 */
+   bn_mulrec(r+2*m,a+m,na-m,b+m,nb-m,w);        /* z2=a1*b1 */
+   sa=w;
+   sb=sa+m+1;
+   z1=sb+m+1;
+   nsa=bn_addmag(sa,a,m,a+m,na-m);
+   nsb=bn_addmag(sb,b,m,b+m,nb-m);
+   bn_mulrec(z1,sa,nsa,sb,nsb,z1+nsa+nsb);      /* (a0+a1)*(b0+b1) */
+   nz1=nsa+nsb;
+   while((nz1>0)&&(z1[nz1-1]==0))
+    nz1--;
+   for(i=2*m;(i>0)&&(r[i-1]==0);i--);
+   nz1=bn_submag(z1,z1,nz1,r,i);                /* z1-=z0 */
+   for(i=na+nb-2*m;(i>0)&&(r[2*m+i-1]==0);i--);
+   nz1=bn_submag(z1,z1,nz1,r+2*m,i);            /* z1-=z2 */
+   if(nz1>0)
+    bn_addmag(r+m,r+m,na+nb-m,z1,nz1);
+  }
+ }
+}
+
+/***********************************************************/
+/* q=a/d for a single limb d (q may alias a): returns a%d  */
+/***********************************************************/
+static uint32_t bn_divmod1(uint32_t *q,const uint32_t *a,int na,uint32_t d)
+{
+ uint64_t cur;
+ int i;
+
+ cur=0;
+ for(i=na-1;i>=0;i--)
+ {
+  cur=(cur<<32)|a[i];
+  q[i]=(uint32_t)(cur/d);
+  cur%=d;
+ }
+ return (uint32_t)cur;
+}
+
+/******************************************************************/
+/* Long division (Knuth, TAOCP Vol2 4.3.1 algorithm D) of u (m    */
+/* limbs) by v (n limbs, n>=2, m>=n): q gets m-n+1 limbs and rem  */
+/* (if not NULL) n limbs. w is a work area of m+n+1 limbs.        */
+/******************************************************************/
+static void bn_divmodn(uint32_t *q,uint32_t *rem,const uint32_t *u,int m,
+                const uint32_t *v,int n,uint32_t *w)
+{
+ uint32_t *un,*vn,x;
+ uint64_t num,qhat,rhat,p;
+ int64_t t,k;
+ int s,i,j;
+
+ un=w;
+ vn=w+m+1;
+ for(s=0,x=v[n-1];!(x&0x80000000U);s++)        /* normalisation */
+  x<<=1;
+ for(i=n-1;i>0;i--)
+  vn[i]=(v[i]<<s)|(s?(v[i-1]>>(32-s)):0);
+ vn[0]=v[0]<<s;
+ un[m]=s?(u[m-1]>>(32-s)):0;
+ for(i=m-1;i>0;i--)
+  un[i]=(u[i]<<s)|(s?(u[i-1]>>(32-s)):0);
+ un[0]=u[0]<<s;
+
+ for(j=m-n;j>=0;j--)
+ {
+  num=((uint64_t)un[j+n]<<32)|un[j+n-1];
+  qhat=num/vn[n-1];
+  rhat=num%vn[n-1];
+  while((qhat>0xffffffffU)||
+        (qhat*vn[n-2]>((rhat<<32)|un[j+n-2])))
+  {
+   qhat--;
+   rhat+=vn[n-1];
+   if(rhat>0xffffffffU)
+    break;
+  }
+  k=0;                          /* un-=qhat*vn */
+  for(i=0;i<n;i++)
+  {
+   p=qhat*vn[i];
+   t=(int64_t)un[i+j]-k-(int64_t)(p&0xffffffffU);
+   un[i+j]=(uint32_t)t;
+   k=(int64_t)(p>>32)-(t>>32);
+  }
+  t=(int64_t)un[j+n]-k;
+  un[j+n]=(uint32_t)t;
+  q[j]=(uint32_t)qhat;
+  if(t<0)                       /* qhat was one too large: add back */
+  {
+   q[j]--;
+   k=0;
+   for(i=0;i<n;i++)
+   {
+    t=(int64_t)un[i+j]+vn[i]+k;
+    un[i+j]=(uint32_t)t;
+    k=t>>32;
+   }
+   un[j+n]+=(uint32_t)k;
+  }
+ }
+ if(rem!=NULL)
+  for(i=0;i<n;i++)
+   rem[i]=(un[i]>>s)|(s?(un[i+1]<<(32-s)):0);
+}
+
+/******** Bigint numbers ********/
+
+/************************/
+/* Allocate a new zero  */
+/************************/
+static s_bigint *bn_alloc(XPRMcontext ctx)
+{
+ s_bigint *b;
+
+ b=malloc(sizeof(s_bigint));
+ if(b==NULL)
+  mm->dispmsg(ctx,"Math: Out of memory error.\n");
+ else
+  {
+  memset(b,0,sizeof(s_bigint));
+  b->refcnt=1;
+ }
+ return b;
+}
+
+/*****************************************/
+/* Make sure b can store at least n limbs */
+/*****************************************/
+static int bn_reserve(XPRMcontext ctx,s_bigint *b,int n)
+{
+ uint32_t *d;
+ int ns;
+
+ if(n<=b->size)
+  return 0;
+ else
+ {
+  ns=(b->size<n-b->size/2)?n:b->size+b->size/2;
+  if((ns<n)||((size_t)ns>(size_t)INT_MAX/sizeof(uint32_t))||
+     ((d=realloc(b->d,ns*sizeof(uint32_t)))==NULL))
+  {
+   mm->dispmsg(ctx,"Math: Out of memory error.\n");
+   return 1;
+  }
+  b->d=d;
+  b->size=ns;
+  return 0;
+ }
+}
+
+/**************************************************/
+/* Temporary (read only) bigint for a 64-bit value */
+/* d must have 2 limbs                            */
+/**************************************************/
+static void bn_tmp64(s_bigint *t,uint32_t *d,int64_t v)
+{
+ uint64_t m;
+
+ t->refcnt=1;
+ t->cst=1;
+ t->sign=(v<0);
+ m=(v<0)?(uint64_t)0-(uint64_t)v:(uint64_t)v;
+ d[0]=(uint32_t)m;
+ d[1]=(uint32_t)(m>>32);
+ t->n=d[1]?2:(d[0]?1:0);
+ t->size=2;
+ t->d=d;
+}
+
+/****************************/
+/* r=b (b==NULL: r=0)       */
+/****************************/
+static int bn_set(XPRMcontext ctx,s_bigint *r,const s_bigint *b)
+{
+ if((b==NULL)||(b->n==0))
+ {
+  r->n=r->sign=0;
+  return 0;
+ }
+ else
+ if(r==b)
+  return 0;
+ else
+ if(bn_reserve(ctx,r,b->n))
+  return 1;
+ else
+ {
+  memcpy(r->d,b->d,b->n*sizeof(uint32_t));
+  r->n=b->n;
+  r->sign=b->sign;
+  return 0;
+ }
+}
+
+/***********************************/
+/* r+=b (or r-=b if neg is not 0)  */
+/***********************************/
+static int bn_addto(XPRMcontext ctx,s_bigint *r,const s_bigint *b,int neg)
+{
+ int sb;
+
+ if((b==NULL)||(b->n==0))
+  return 0;
+ sb=b->sign^(neg!=0);
+ if((r->n==0)||(r->sign==sb))
+ {
+  if(bn_reserve(ctx,r,((r->n>b->n)?r->n:b->n)+1))
+   return 1;
+  r->n=bn_addmag(r->d,r->d,r->n,b->d,b->n);
+  r->sign=sb;
+ }
+ else
+ if(bn_cmpmag(r->d,r->n,b->d,b->n)>=0)
+ {
+  r->n=bn_submag(r->d,r->d,r->n,b->d,b->n);
+  if(r->n==0)
+   r->sign=0;
+ }
+ else
+ {
+  if(bn_reserve(ctx,r,b->n))
+   return 1;
+  r->n=bn_submag(r->d,b->d,b->n,r->d,r->n);
+  r->sign=sb;
+ }
+ return 0;
+}
+
+/**********/
+/* r*=b   */
+/**********/
+static int bn_mulby(XPRMcontext ctx,s_bigint *r,const s_bigint *b)
+{
+ uint32_t *t;
+ size_t nt;
+ int n;
+
+ if((b==NULL)||(b->n==0)||(r->n==0))
+ {
+  r->n=r->sign=0;
+  return 0;
+ }
+ n=r->n+b->n;
+ if(b->n==1)                    /* single limb: in place */
+ {
+  uint64_t c;
+  uint32_t m;
+  int i;
+
+  if(bn_reserve(ctx,r,n))
+   return 1;
+  m=b->d[0];
+  c=0;
+  for(i=0;i<r->n;i++)
+  {
+   c+=(uint64_t)r->d[i]*m;
+   r->d[i]=(uint32_t)c;
+   c>>=32;
+  }
+  if(c)
+   r->d[r->n++]=(uint32_t)c;
+  r->sign^=b->sign;
+  return 0;
+ }
+ nt=(size_t)n+((b->n<BN_KARATSUBA)?0:(size_t)4*n+64);
+ if((n<0)||((t=malloc(nt*sizeof(uint32_t)))==NULL))
+ {
+  mm->dispmsg(ctx,"Math: Out of memory error.\n");
+  return 1;
+ }
+ bn_mulrec(t,r->d,r->n,b->d,b->n,t+n);
+ while(t[n-1]==0)
+  n--;
+ free(r->d);
+ r->d=t;
+ r->size=(nt>(size_t)INT_MAX)?n:(int)nt;
+ r->n=n;
+ r->sign^=b->sign;
+ return 0;
+}
+
+/*******************************************************/
+/* r=r div b (or r mod b if mod is not 0) with b<>0:   */
+/* the quotient is truncated and the remainder has the */
+/* sign of r (like for integer and int64)              */
+/*******************************************************/
+static int bn_divby(XPRMcontext ctx,s_bigint *r,const s_bigint *b,int mod)
+{
+ uint32_t *t;
+ uint32_t rm;
+ int m,n;
+
+ m=r->n;
+ n=b->n;
+ if(bn_cmpmag(r->d,m,b->d,n)<0)
+ {
+  if(!mod)
+   r->n=r->sign=0;
+  return 0;
+ }
+ else
+ if(n==1)
+ {
+  rm=bn_divmod1(r->d,r->d,m,b->d[0]);
+  if(mod)
+  {
+   r->d[0]=rm;
+   r->n=rm?1:0;
+  }
+  else
+  {
+   while((m>0)&&(r->d[m-1]==0))
+    m--;
+   r->n=m;
+   r->sign^=b->sign;
+  }
+ }
+ else
+ {
+  if((t=malloc((size_t)(3*m+n+2)*sizeof(uint32_t)))==NULL)
+  {
+   mm->dispmsg(ctx,"Math: Out of memory error.\n");
+   return 1;
+  }
+  bn_divmodn(t,t+m,r->d,m,b->d,n,t+m+n);
+  if(mod)
+  {
+   memcpy(r->d,t+m,n*sizeof(uint32_t));
+   m=n;
+  }
+  else
+  {
+   memcpy(r->d,t,(m-n+1)*sizeof(uint32_t));
+   m=m-n+1;
+   r->sign^=b->sign;
+  }
+  free(t);
+  while((m>0)&&(r->d[m-1]==0))
+   m--;
+  r->n=m;
+ }
+ if(r->n==0)
+  r->sign=0;
+ return 0;
+}
+
+/********************************************/
+/* Value as an int64 (1 if it does not fit) */
+/********************************************/
+static int bn_toint64(const s_bigint *b,int64_t *v)
+{
+ uint64_t m;
+
+ if((b==NULL)||(b->n==0))
+ {
+  *v=0;
+  return 0;
+ }
+ else
+ if(b->n>2)
+  return 1;
+ else
+ {
+  m=b->d[0];
+  if(b->n>1)
+   m|=(uint64_t)b->d[1]<<32;
+  if(m>(b->sign?(uint64_t)1<<63:((uint64_t)1<<63)-1))
+   return 1;
+  *v=(int64_t)(b->sign?(uint64_t)0-m:m);
+  return 0;
+ }
+}
+
+/************************************************************/
+/* Decimal representation (to be released with free): the  */
+/* number is divided by 10^9 to get 9 digits at each pass   */
+/************************************************************/
+static char *bn_todec(XPRMcontext ctx,const s_bigint *b,int *len)
+{
+ uint32_t *t,*ch;
+ char *str,*s;
+ int n,nch,i;
+
+ n=(b==NULL)?0:b->n;
+                        /* n limbs give at most 1.07*n chunks */
+ if((t=malloc((size_t)(2*n+n/8+2)*sizeof(uint32_t)))==NULL)
+  str=NULL;
+ else
+ {
+  memcpy(t,b!=NULL?b->d:t,n*sizeof(uint32_t));
+  ch=t+n;
+  nch=0;
+  while(n>0)                    /* chunks of 9 digits (lowest first) */
+  {
+   ch[nch++]=bn_divmod1(t,t,n,BN_DEC);
+   while((n>0)&&(t[n-1]==0))
+    n--;
+  }
+  if((str=malloc((size_t)nch*BN_DECDIG+3))!=NULL)
+  {
+   s=str;
+   if((b!=NULL)&&b->sign)
+    *(s++)='-';
+   if(nch==0)
+    *(s++)='0';
+   else
+   {
+    s+=sprintf(s,"%u",ch[nch-1]);
+    for(i=nch-2;i>=0;i--)
+     s+=sprintf(s,"%09u",ch[i]);
+   }
+   *s='\0';
+   *len=(int)(s-str);
+  }
+  free(t);
+ }
+ if(str==NULL)
+  mm->dispmsg(ctx,"Math: Out of memory error.\n");
+ return str;
+}
+
+/********************************************************/
+/* Read a decimal number: the digits are processed by   */
+/* groups of 9 (b=b*10^9+group)                          */
+/********************************************************/
+static int bn_fromdec(XPRMcontext ctx,s_bigint *b,const char *str,
+                const char **endptr)
+{
+ static const uint32_t p10[]={1,10,100,1000,10000,100000,1000000,
+                              10000000,100000000,BN_DEC};
+ const char *s;
+ uint64_t c;
+ uint32_t g;
+ int neg,nd,k,i;
+
+ s=str;
+ while(isspace((unsigned char)*s))
+  s++;
+ neg=(*s=='-');
+ if((*s=='-')||(*s=='+'))
+  s++;
+ for(nd=0;isdigit((unsigned char)s[nd]);nd++);
+ if(endptr!=NULL)
+  *endptr=s+nd;
+ if(nd==0)
+  return 1;
+ if(bn_reserve(ctx,b,(int)(nd/BN_DECDIG)+2))
+  return 1;
+ b->n=0;
+ k=nd%BN_DECDIG;
+ if(k==0)
+  k=BN_DECDIG;
+ while(nd>0)
+ {
+  for(g=0,i=0;i<k;i++)
+   g=g*10+(uint32_t)(*(s++)-'0');
+  c=g;                          /* b=b*10^k+g */
+  for(i=0;i<b->n;i++)
+  {
+   c+=(uint64_t)b->d[i]*p10[k];
+   b->d[i]=(uint32_t)c;
+   c>>=32;
+  }
+  if(c)
+   b->d[b->n++]=(uint32_t)c;
+  nd-=k;
+  k=BN_DECDIG;
+ }
+ b->sign=neg&&(b->n>0);
+ return 0;
+}
+
+/******** Functions implementing the operators ********/
+
+/*******************/
+/* Clone a bigint  */
+/*******************/
+static int bn_new0(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,*r2;
+
+ r1=XPRM_POP_REF(ctx);
+ if(r1!=NULL)
+ {
+  if(((r2=bn_alloc(ctx))==NULL)||bn_set(ctx,r2,r1))
+  {
+   bn_delete(ctx,libctx,r2,0);
+   return XPRM_RT_ERROR;
+  }
+  XPRM_PUSH_REF(ctx,r2);
+ }
+ else
+  XPRM_PUSH_REF(ctx,NULL);
+ return XPRM_RT_OK;
+}
+
+/*********************************************/
+/* Create a bigint from a real (truncated)   */
+/*********************************************/
+static int bn_new1r(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,t;
+ uint32_t d[2];
+ double x,f;
+ int e;
+
+ x=XPRM_POP_REAL(ctx);
+ if((r1=bn_alloc(ctx))==NULL)
+  return XPRM_RT_ERROR;
+ x=(x<0)?ceil(x):floor(x);
+ if(!isfinite(x))
+ {
+  mm->dispmsg(ctx,"Math: Invalid value for a bigint.\n");
+  XPRM_PUSH_REF(ctx,r1);
+  return XPRM_RT_MATHERR;
+ }
+ f=frexp(x,&e);                 /* x=f.2^e with f on 53 bits */
+ if(e<=53)
+  bn_tmp64(&t,d,(int64_t)x);
+ else
+  bn_tmp64(&t,d,(int64_t)ldexp(f,53));
+ if(bn_set(ctx,r1,&t))
+ {
+  bn_delete(ctx,libctx,r1,0);
+  return XPRM_RT_ERROR;
+ }
+ for(e-=53;e>0;e-=30)           /* multiply by 2^(e-53) */
+ {
+  bn_tmp64(&t,d,(int64_t)1<<((e>30)?30:e));
+  if(bn_mulby(ctx,r1,&t))
+  {
+   bn_delete(ctx,libctx,r1,0);
+   return XPRM_RT_ERROR;
+  }
+ }
+ XPRM_PUSH_REF(ctx,r1);
+ return XPRM_RT_OK;
+}
+
+/************************************/
+/* Create a bigint from an integer  */
+/************************************/
+static int bn_new1i(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,t;
+ uint32_t d[2];
+
+ bn_tmp64(&t,d,XPRM_POP_INT(ctx));
+ if(((r1=bn_alloc(ctx))==NULL)||bn_set(ctx,r1,&t))
+ {
+  bn_delete(ctx,libctx,r1,0);
+  return XPRM_RT_ERROR;
+ }
+ XPRM_PUSH_REF(ctx,r1);
+ return XPRM_RT_OK;
+}
+
+/***********************************/
+/* Create a bigint from an int64   */
+/***********************************/
+static int bn_new1l(XPRMcontext ctx,void *libctx)
+{
+ s_mathctx *mactx=libctx;
+ s_bigint *r1,t;
+ uint32_t d[2];
+
+ bn_tmp64(&t,d,bi_value(mactx,XPRM_POP_REF(ctx)));
+ if(((r1=bn_alloc(ctx))==NULL)||bn_set(ctx,r1,&t))
+ {
+  bn_delete(ctx,libctx,r1,0);
+  return XPRM_RT_ERROR;
+ }
+ XPRM_PUSH_REF(ctx,r1);
+ return XPRM_RT_OK;
+}
+
+/*********************************/
+/* Create a bigint from a string */
+/*********************************/
+static int bn_new1s(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1;
+ const char *str,*ep;
+
+ str=XPRM_POP_STRING(ctx);
+ if((r1=bn_alloc(ctx))==NULL)
+  return XPRM_RT_ERROR;
+ if(str==NULL)
+  str="0";
+ if(bn_fromdec(ctx,r1,str,&ep)||(*ep!='\0'))
+ {
+  mm->dispmsg(ctx,"Math: Invalid bigint `%s'.\n",str);
+  bn_delete(ctx,libctx,r1,0);
+  return XPRM_RT_ERROR;
+ }
+ XPRM_PUSH_REF(ctx,r1);
+ return XPRM_RT_OK;
+}
+
+/*********************************************/
+/* Zero in bigint (used to initialise `sum') */
+/*********************************************/
+static int bn_zero(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1;
+
+ if((r1=bn_alloc(ctx))==NULL)
+  return XPRM_RT_ERROR;
+ XPRM_PUSH_REF(ctx,r1);
+ return XPRM_RT_OK;
+}
+
+/*********************************************/
+/* One in bigint (used to initialise `prod') */
+/*********************************************/
+static int bn_one(XPRMcontext ctx,void *libctx)
+{
+ XPRM_PUSH_INT(ctx,1);
+ return bn_new1i(ctx,libctx);
+}
+
+/*****************************/
+/* Assignment bigint:=bigint */
+/*****************************/
+static int bn_asgn(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,*r2;
+ int rts;
+
+ r1=XPRM_POP_REF(ctx);
+ r2=XPRM_POP_REF(ctx);
+ if(r1==NULL)
+ {
+  mm->dispmsg(ctx,"Math: Trying to access an uninitialized bigint.\n");
+  bn_delete(ctx,libctx,r2,0);
+  return RT_ERROR;
+ }
+ else
+ if(r1->cst)
+ {
+  mm->dispmsg(ctx,"Math: Trying to modify a constant.\n");
+  bn_delete(ctx,libctx,r2,0);
+  return RT_ERROR;
+ }
+ else
+ if((r2!=NULL)&&(r2->refcnt==1)&&(r1!=r2))
+ {                              /* Temporary value: take its limbs */
+  uint32_t *d;
+  int s;
+
+  d=r1->d; r1->d=r2->d; r2->d=d;
+  s=r1->size; r1->size=r2->size; r2->size=s;
+  r1->n=r2->n;
+  r1->sign=r2->sign;
+  bn_delete(ctx,libctx,r2,0);
+  return XPRM_RT_OK;
+ }
+ else
+ {
+  rts=bn_set(ctx,r1,r2);
+  bn_delete(ctx,libctx,r2,0);
+  return rts?XPRM_RT_ERROR:XPRM_RT_OK;
+ }
+}
+
+/*******************************/
+/* Assignment bigint:=integer  */
+/*******************************/
+static int bn_asgn_i(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,t;
+ uint32_t d[2];
+
+ r1=XPRM_POP_REF(ctx);
+ if(r1==NULL)
+ {
+  mm->dispmsg(ctx,"Math: Trying to access an uninitialized bigint.\n");
+  return RT_ERROR;
+ }
+ else
+ if(r1->cst)
+ {
+  mm->dispmsg(ctx,"Math: Trying to modify a constant.\n");
+  return RT_ERROR;
+ }
+ else
+ {
+  bn_tmp64(&t,d,XPRM_POP_INT(ctx));
+  return bn_set(ctx,r1,&t)?XPRM_RT_ERROR:XPRM_RT_OK;
+ }
+}
+
+/************************************/
+/* Addition bigint+bigint -> bigint */
+/************************************/
+static int bn_pls(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,*r2;
+ int rts;
+
+ r1=XPRM_POP_REF(ctx);
+ r2=XPRM_POP_REF(ctx);
+ if(r1!=NULL)
+ {
+  rts=bn_addto(ctx,r1,r2,0);
+  bn_delete(ctx,libctx,r2,0);
+  XPRM_PUSH_REF(ctx,r1);
+  return rts?XPRM_RT_ERROR:XPRM_RT_OK;
+ }
+ else
+ {
+  XPRM_PUSH_REF(ctx,r2);
+  return XPRM_RT_OK;
+ }
+}
+
+/*************************************/
+/* Addition bigint+integer -> bigint */
+/*************************************/
+static int bn_pls_i(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,t;
+ uint32_t d[2];
+
+ r1=XPRM_POP_REF(ctx);
+ if(r1!=NULL)
+ {
+  bn_tmp64(&t,d,XPRM_POP_INT(ctx));
+  XPRM_PUSH_REF(ctx,r1);
+  return bn_addto(ctx,r1,&t,0)?XPRM_RT_ERROR:XPRM_RT_OK;
+ }
+ else
+  return bn_new1i(ctx,libctx);
+}
+
+/***********************************/
+/* Product bigint*bigint -> bigint */
+/***********************************/
+static int bn_mul(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,*r2;
+ int rts;
+
+ r1=XPRM_POP_REF(ctx);
+ r2=XPRM_POP_REF(ctx);
+ rts=(r1!=NULL)?bn_mulby(ctx,r1,r2):0;
+ bn_delete(ctx,libctx,r2,0);
+ XPRM_PUSH_REF(ctx,r1);
+ return rts?XPRM_RT_ERROR:XPRM_RT_OK;
+}
+
+/************************************/
+/* Product bigint*integer -> bigint */
+/************************************/
+static int bn_mul_i(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,t;
+ uint32_t d[2];
+
+ r1=XPRM_POP_REF(ctx);
+ bn_tmp64(&t,d,XPRM_POP_INT(ctx));
+ XPRM_PUSH_REF(ctx,r1);
+ return ((r1!=NULL)&&bn_mulby(ctx,r1,&t))?XPRM_RT_ERROR:XPRM_RT_OK;
+}
+
+/*************************************/
+/* Change of sign bigint -> -bigint  */
+/*************************************/
+static int bn_neg(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1;
+
+ r1=XPRM_POP_REF(ctx);
+ if((r1!=NULL)&&(r1->n>0))
+  r1->sign=!r1->sign;
+ XPRM_PUSH_REF(ctx,r1);
+ return XPRM_RT_OK;
+}
+
+/****************************************************/
+/* Division bigint div/mod bigint -> bigint         */
+/****************************************************/
+static int bn_divop(XPRMcontext ctx,void *libctx,int mod)
+{
+ s_bigint *r1,*r2;
+ int rts;
+
+ r1=XPRM_POP_REF(ctx);
+ r2=XPRM_POP_REF(ctx);
+ if((r2==NULL)||(r2->n==0))
+ {
+  mm->dispmsg(ctx,"Math: Division by 0.\n");
+  if(r1!=NULL)
+   r1->n=r1->sign=0;
+  rts=XPRM_RT_MATHERR;
+ }
+ else
+  rts=((r1!=NULL)&&bn_divby(ctx,r1,r2,mod))?XPRM_RT_ERROR:XPRM_RT_OK;
+ bn_delete(ctx,libctx,r2,0);
+ XPRM_PUSH_REF(ctx,r1);
+ return rts;
+}
+
+/***************************************/
+/* Division bigint div bigint -> bigint */
+/***************************************/
+static int bn_idiv(XPRMcontext ctx,void *libctx)
+{
+ return bn_divop(ctx,libctx,0);
+}
+
+/***************************************/
+/* Division bigint mod bigint -> bigint */
+/***************************************/
+static int bn_mod(XPRMcontext ctx,void *libctx)
+{
+ return bn_divop(ctx,libctx,1);
+}
+
+/***********************/
+/* abs(bigint)->bigint */
+/***********************/
+static int bn_abs(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1,*r2;
+
+ r1=XPRM_POP_REF(ctx);
+ if(((r2=bn_alloc(ctx))==NULL)||bn_set(ctx,r2,r1))
+ {
+  bn_delete(ctx,libctx,r2,0);
+  return XPRM_RT_ERROR;
+ }
+ r2->sign=0;
+ XPRM_PUSH_REF(ctx,r2);
+ return XPRM_RT_OK;
+}
+
+/***********************/
+/* isodd(bigint)->bool */
+/***********************/
+static int bn_isodd(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1;
+
+ r1=XPRM_POP_REF(ctx);
+ XPRM_PUSH_INT(ctx,(r1!=NULL)&&(r1->n>0)&&(r1->d[0]&1));
+ return XPRM_RT_OK;
+}
+
+/****************/
+/* bigint->real */
+/****************/
+static int bn_asreal(XPRMcontext ctx,void *libctx)
+{
+ s_bigint *r1;
+ double x;
+ int i;
+
+ r1=XPRM_POP_REF(ctx);
+ x=0;
+ if(r1!=NULL)
+ {
+  for(i=r1->n-1;i>=0;i--)
+   x=x*4294967296.0+r1->d[i];
+  if(r1->sign)
+   x=-x;
+ }
+ XPRM_PUSH_REAL(ctx,x);
+ return XPRM_RT_OK;
+}
+
+/*****************************************/
+/* bigint->int64 (error if out of range) */
+/*****************************************/
+static int bn_asi64(XPRMcontext ctx,void *libctx)
+{
+ s_mathctx *mactx=libctx;
+ int64_t v;
+ void *r;
+
+ if(bn_toint64(XPRM_POP_REF(ctx),&v))
+ {
+  mm->dispmsg(ctx,"Math: bigint value out of int64 range.\n");
+  return XPRM_RT_MATHERR;
+ }
+ r=bi_result(ctx,mactx,NULL,v);
+ if(r==NULL)
+  return XPRM_RT_ERROR;
+ XPRM_PUSH_REF(ctx,r);
+ return XPRM_RT_OK;
+}
+
+/*****************************/
+/* Allocate a bigint number  */
+/*****************************/
+static void *bn_create(XPRMcontext ctx,void *libctx,void *todup,int typnum)
+{
+ s_bigint *b;
+
+ if((todup!=NULL)&&(XPRM_CREATE(typnum)==XPRM_CREATE_NEW))
+ {
+  ((s_bigint *)todup)->refcnt++;
+  return todup;
+ }
+ else
+ if((b=bn_alloc(ctx))==NULL)
+  return NULL;
+ else
+ if(XPRM_CREATE(typnum)==XPRM_CREATE_CST)
+ {
+  if(bn_set(ctx,b,todup))
+  {
+   bn_delete(ctx,libctx,b,0);
+   return NULL;
+  }
+  b->cst=1;
+ }
+ return b;
+}
+
+/*******************************/
+/* Deallocate a bigint number  */
+/*******************************/
+static void bn_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum)
+{
+ s_bigint *b;
+
+ b=todel;
+ if((b!=NULL)&&(--b->refcnt<1))
+ {
+  free(b->d);
+  free(b);
+ }
+}
+
+/********************/
+/* bigint -> String */
+/********************/
+/* Binary format: number of limbs and sign (bit 31) on 4 bytes */
+/* followed by the limbs (little endian)                        */
+static int bn_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,int len,int typnum)
+{
+ s_bigint *b;
+ char *s;
+ uint32_t h;
+ int l;
+
+ b=toprt;
+ if(typnum&XPRM_TFSTR_BIN)
+ {
+  l=(int)((1+((b==NULL)?0:b->n))*sizeof(uint32_t));
+  if(len>=l)
+  {
+   /* We assume that all supported platforms are little endian */
+   h=(b==NULL)?0:((uint32_t)b->n|(b->sign?0x80000000U:0));
+   memcpy(str,&h,sizeof(uint32_t));
+   if(l>(int)sizeof(uint32_t))
+    memcpy(str+sizeof(uint32_t),b->d,l-sizeof(uint32_t));
+  }
+  return l;
+ }
+ else
+ if((b==NULL)||(b->n==0))
+ {
+  if(len>0)
+   strncpy(str,"0",len);
+  return 1;
+ }
+ else
+ if((s=bn_todec(ctx,b,&l))==NULL)
+  return -1;
+ else
+ {
+  if(len>0)
+  {
+   memcpy(str,s,(l<len)?l:len-1);
+   str[(l<len)?l:len-1]='\0';
+  }
+  free(s);
+  return l;
+ }
+}
+
+/********************/
+/* String -> bigint */
+/********************/
+static int bn_fromstr(XPRMcontext ctx,void *libctx,void *toinit,const char *str,int typnum,const char **endptr)
+{
+ s_bigint *b;
+ uint32_t h;
+ int n;
+
+ b=toinit;
+ if(b->cst)
+ {
+  mm->dispmsg(ctx,"Math: Trying to modify a constant.\n");
+  return XPRM_RT_ERROR;
+ }
+ else
+ if(typnum&XPRM_TFSTR_BIN)
+ {
+  if(*endptr-str<(int)sizeof(uint32_t))
+   return XPRM_RT_ERROR;
+  /* We assume that all supported platforms are little endian */
+  memcpy(&h,str,sizeof(uint32_t));
+  n=(int)(h&0x7fffffffU);
+  if((*endptr-str!=(long)((n+1)*sizeof(uint32_t)))||bn_reserve(ctx,b,n))
+   return XPRM_RT_ERROR;
+  if(n>0)
+   memcpy(b->d,str+sizeof(uint32_t),n*sizeof(uint32_t));
+  while((n>0)&&(b->d[n-1]==0))
+   n--;
+  b->n=n;
+  b->sign=(n>0)&&(h&0x80000000U);
+  return XPRM_RT_OK;
+ }
+ else
+  return bn_fromdec(ctx,b,str,endptr)?XPRM_RT_ERROR:XPRM_RT_OK;
+}
+
+/******************/
+/* Copy a bigint  */
+/******************/
+static int bn_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,int typnum)
+{
+ s_bigint *b,*s;
+ int sign;
+
+ b=toinit;
+ s=src;
+ switch(XPRM_CPY(typnum))
+ {
+  case XPRM_CPY_COPY:
+  case XPRM_CPY_RESET:
+      if(b->cst)
+       return 1;
+      else
+       return bn_set(ctx,b,s);
+  case XPRM_CPY_APPEND:         /* x+=y: updated in place */
+      if(b->cst)
+       return 1;
+      else
+       return bn_addto(ctx,b,s,0);
+  case XPRM_CPY_HASH:
+      sign=(s!=NULL)&&s->sign;
+      *(unsigned int *)toinit=mm->hashmix(ctx,0,&sign,sizeof(int));
+      if((s!=NULL)&&(s->n>0))
+       *(unsigned int *)toinit=mm->hashmix(ctx,*(unsigned int *)toinit,
+                                  s->d,s->n*sizeof(uint32_t));
+      return 0;
+  default:
+      return 1;
+ }
+}
+
+/***************************/
+/* Compare 2 bigint values */
+/***************************/
+static int bn_compare(XPRMcontext ctx,void *libctx,void *r1,void *r2,int typnum)
+{
+ s_bigint *b1,*b2;
+ int c;
+
+ b1=r1;
+ b2=r2;
+ if((b1==NULL)||(b1->n==0))
+  c=((b2==NULL)||(b2->n==0))?0:(b2->sign?1:-1);
+ else
+ if((b2==NULL)||(b2->n==0))
+  c=b1->sign?-1:1;
+ else
+ if(b1->sign!=b2->sign)
+  c=b1->sign?-1:1;
+ else
+ {
+  c=bn_cmpmag(b1->d,b1->n,b2->d,b2->n);
+  if(b1->sign)
+   c=-c;
+ }
+
+ switch(XPRM_COMPARE(typnum))
+ {
+  case XPRM_COMPARE_EQ: return c==0;
+  case XPRM_COMPARE_NEQ: return c!=0;
+  case XPRM_COMPARE_LTH: return c<0;
+  case XPRM_COMPARE_LEQ: return c<=0;
+  case XPRM_COMPARE_GEQ: return c>=0;
+  case XPRM_COMPARE_GTH: return c>0;
+  case XPRM_COMPARE_CMP: return c;
+  default:
+    return XPRM_COMPARE_ERROR;
+ }
+}
@@ -2,8 +2,8 @@
   File math.c
   ```````````
   Example module defining a set of
-  mathematical functions and
-  an int64 type
+  mathematical functions,
+  an int64 type and a bigint type
 
   author: Y. Colombani, rev. Apr. 2023
 
@@ -27,8 +27,8 @@ cl /nologo /MD /I%XPRESSDIR%\include /LD math.c /Femath.dso
 gcc -Wall -o math.dso -shared -D_REENTRANT -I${XPRESSDIR}/include math.c -lm
 */
 #define VMAJ 1
-#define VMIN 0
-#define VREL 1
+#define VMIN 1
+#define VREL 0
 
 #include <stdlib.h>
 #include <string.h>
@@ -40,6 +40,7 @@ gcc -Wall -o math.dso -shared -D_REENTRANT -I${XPRESSDIR}/include math.c -lm
 
 /**** Function prototypes ****/
 static int chkerror(XPRMcontext ctx,const char *fct);
+static int samesets(XPRMcontext ctx,XPRMarray a1,XPRMarray a2);
 
 static int ma_tan(XPRMcontext ctx,void *libctx);
 static int ma_asin(XPRMcontext ctx,void *libctx);
@@ -74,6 +75,21 @@ static int ma_jn(XPRMcontext ctx,void *libctx);
 static int ma_y0(XPRMcontext ctx,void *libctx);
 static int ma_y1(XPRMcontext ctx,void *libctx);
 static int ma_yn(XPRMcontext ctx,void *libctx);
+static int ma_aeval(XPRMcontext ctx,double (*f1)(double),
+                double (*f2)(double,double),const char *fct);
+static int ma_tan_a(XPRMcontext ctx,void *libctx);
+static int ma_asin_a(XPRMcontext ctx,void *libctx);
+static int ma_acos_a(XPRMcontext ctx,void *libctx);
+static int ma_atan2_a(XPRMcontext ctx,void *libctx);
+static int ma_cosh_a(XPRMcontext ctx,void *libctx);
+static int ma_sinh_a(XPRMcontext ctx,void *libctx);
+static int ma_tanh_a(XPRMcontext ctx,void *libctx);
+static int ma_acosh_a(XPRMcontext ctx,void *libctx);
+static int ma_asinh_a(XPRMcontext ctx,void *libctx);
+static int ma_atanh_a(XPRMcontext ctx,void *libctx);
+static int ma_hypot_a(XPRMcontext ctx,void *libctx);
+static int ma_log1p_a(XPRMcontext ctx,void *libctx);
+static int ma_cbrt_a(XPRMcontext ctx,void *libctx);
 
 static void *ma_reset(XPRMcontext ctx,void *libctx,int version);
 static int ma_chkver(int);
@@ -119,14 +135,50 @@ static int bi_lt_i(XPRMcontext ctx,void *libctx);
 static int bi_lt_i2(XPRMcontext ctx,void *libctx);
 static int bi_gt_i(XPRMcontext ctx,void *libctx);
 static int bi_gt_i2(XPRMcontext ctx,void *libctx);
+static int bi_asum(XPRMcontext ctx,void *libctx);
+static int bi_amin(XPRMcontext ctx,void *libctx);
+static int bi_amax(XPRMcontext ctx,void *libctx);
+static int bi_adot(XPRMcontext ctx,void *libctx);
 static int bi_tostr(XPRMcontext ctx,void *,void *,char *,int,int);
 static int bi_fromstr(XPRMcontext ctx,void *libctx,void *toinit,const char *str,int,const char **endptr);
 static int bi_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,int typnum);
 static int bi_compare(XPRMcontext ctx,void *libctx,void *c1,void *c2,int typnum);
 static void *bi_create(XPRMcontext ctx,void *,void *,int);
 static void bi_delete(XPRMcontext ctx,void *,void *,int);
+static void bi_freeall(struct MathCtx *mactx);
 static int64_t imci_getint64val(XPRMcontext ctx,struct MathCtx *mactx,void *ref);
 static int imci_setint64val(XPRMcontext ctx,struct MathCtx *mactx,void *ref,int64_t v);
+static int imci_getint64vec(XPRMcontext ctx,struct MathCtx *mactx,void **refs,int n,int64_t *v);
+static int imci_setint64vec(XPRMcontext ctx,struct MathCtx *mactx,void **refs,int n,const int64_t *v);
+static int imci_newint64vec(XPRMcontext ctx,struct MathCtx *mactx,void **refs,int n,const int64_t *v);
+
+					/* From bignum.c */
+static int bn_new0(XPRMcontext ctx,void *libctx);
+static int bn_new1r(XPRMcontext ctx,void *libctx);
+static int bn_new1i(XPRMcontext ctx,void *libctx);
+static int bn_new1l(XPRMcontext ctx,void *libctx);
+static int bn_new1s(XPRMcontext ctx,void *libctx);
+static int bn_zero(XPRMcontext ctx,void *libctx);
+static int bn_one(XPRMcontext ctx,void *libctx);
+static int bn_asgn(XPRMcontext ctx,void *libctx);
+static int bn_asgn_i(XPRMcontext ctx,void *libctx);
+static int bn_pls(XPRMcontext ctx,void *libctx);
+static int bn_pls_i(XPRMcontext ctx,void *libctx);
+static int bn_mul(XPRMcontext ctx,void *libctx);
+static int bn_mul_i(XPRMcontext ctx,void *libctx);
+static int bn_neg(XPRMcontext ctx,void *libctx);
+static int bn_idiv(XPRMcontext ctx,void *libctx);
+static int bn_mod(XPRMcontext ctx,void *libctx);
+static int bn_abs(XPRMcontext ctx,void *libctx);
+static int bn_isodd(XPRMcontext ctx,void *libctx);
+static int bn_asreal(XPRMcontext ctx,void *libctx);
+static int bn_asi64(XPRMcontext ctx,void *libctx);
+static int bn_tostr(XPRMcontext ctx,void *,void *,char *,int,int);
+static int bn_fromstr(XPRMcontext ctx,void *libctx,void *toinit,const char *str,int,const char **endptr);
+static int bn_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,int typnum);
+static int bn_compare(XPRMcontext ctx,void *libctx,void *c1,void *c2,int typnum);
+static void *bn_create(XPRMcontext ctx,void *,void *,int);
+static void bn_delete(XPRMcontext ctx,void *,void *,int);
 
 /**** Structures for passing info to Mosel ****/
 /* Constants */
@@ -197,6 +249,20 @@ static XPRMdsofct tabfct[]=
          {"y1",1124,XPRM_TYP_REAL,1,"r",ma_y1},
          {"yn",1125,XPRM_TYP_REAL,2,"ir",ma_yn},
 
+         {"tan",1060,XPRM_TYP_NOT,2,"A.rA.r",ma_tan_a},
+         {"arcsin",1061,XPRM_TYP_NOT,2,"A.rA.r",ma_asin_a},
+         {"arccos",1062,XPRM_TYP_NOT,2,"A.rA.r",ma_acos_a},
+         {"arctan2",1063,XPRM_TYP_NOT,3,"A.rA.rA.r",ma_atan2_a},
+         {"cosh",1064,XPRM_TYP_NOT,2,"A.rA.r",ma_cosh_a},
+         {"sinh",1065,XPRM_TYP_NOT,2,"A.rA.r",ma_sinh_a},
+         {"tanh",1066,XPRM_TYP_NOT,2,"A.rA.r",ma_tanh_a},
+         {"arccosh",1067,XPRM_TYP_NOT,2,"A.rA.r",ma_acosh_a},
+         {"arcsinh",1068,XPRM_TYP_NOT,2,"A.rA.r",ma_asinh_a},
+         {"arctanh",1069,XPRM_TYP_NOT,2,"A.rA.r",ma_atanh_a},
+         {"hypot",1070,XPRM_TYP_NOT,3,"A.rA.rA.r",ma_hypot_a},
+         {"log1p",1071,XPRM_TYP_NOT,2,"A.rA.r",ma_log1p_a},
+         {"cbrt",1072,XPRM_TYP_NOT,2,"A.rA.r",ma_cbrt_a},
+
          {"@&",1300,XPRM_TYP_EXTN,1,"int64:|int64|",bi_new0},
          {"@&",1301,XPRM_TYP_EXTN,1,"int64:r",bi_new1r},
          {"@&I",1302,XPRM_TYP_EXTN,1,"int64:i",bi_new1i},
@@ -236,20 +302,51 @@ static XPRMdsofct tabfct[]=
          {"isodd",1371,XPRM_TYP_BOOL,1,"|int64|",bi_isodd},
          {"abs",1372,XPRM_TYP_EXTN,1,"int64:|int64|",bi_abs},
          {"getasint",1373,XPRM_TYP_INT,1,"|int64|",bi_asint},
-         {"getasreal",1374,XPRM_TYP_REAL,1,"|int64|",bi_asreal}
+         {"getasreal",1374,XPRM_TYP_REAL,1,"|int64|",bi_asreal},
+
+         {"sum_i64",1380,XPRM_TYP_EXTN,1,"int64:A.|int64|",bi_asum},
+         {"min_i64",1381,XPRM_TYP_EXTN,1,"int64:A.|int64|",bi_amin},
+         {"max_i64",1382,XPRM_TYP_EXTN,1,"int64:A.|int64|",bi_amax},
+         {"dot_i64",1383,XPRM_TYP_EXTN,2,"int64:A.|int64|A.|int64|",bi_adot},
+
+         {"@&",1400,XPRM_TYP_EXTN,1,"bigint:|bigint|",bn_new0},
+         {"@&",1401,XPRM_TYP_EXTN,1,"bigint:r",bn_new1r},
+         {"@&I",1402,XPRM_TYP_EXTN,1,"bigint:i",bn_new1i},
+         {"@&",1403,XPRM_TYP_EXTN,1,"bigint:|int64|",bn_new1l},
+         {"@&",1404,XPRM_TYP_EXTN,1,"bigint:s",bn_new1s},
+         {"@0",1405,XPRM_TYP_EXTN,0,"bigint:",bn_zero},
+         {"@1",1406,XPRM_TYP_EXTN,0,"bigint:",bn_one},
+         {"@:",1407,XPRM_TYP_NOT,2,"|bigint||bigint|",bn_asgn},
+         {"@:",1408,XPRM_TYP_NOT,2,"|bigint|i",bn_asgn_i},
+         {"@+",1409,XPRM_TYP_EXTN,2,"bigint:|bigint||bigint|",bn_pls},
+         {"@+",1410,XPRM_TYP_EXTN,2,"bigint:|bigint|i",bn_pls_i},
+         {"@*",1411,XPRM_TYP_EXTN,2,"bigint:|bigint||bigint|",bn_mul},
+         {"@*",1412,XPRM_TYP_EXTN,2,"bigint:|bigint|i",bn_mul_i},
+         {"@-",1413,XPRM_TYP_EXTN,1,"bigint:|bigint|",bn_neg},
+         {"@d",1414,XPRM_TYP_EXTN,2,"bigint:|bigint||bigint|",bn_idiv},
+         {"@m",1415,XPRM_TYP_EXTN,2,"bigint:|bigint||bigint|",bn_mod},
+
+         {"abs",1420,XPRM_TYP_EXTN,1,"bigint:|bigint|",bn_abs},
+         {"isodd",1421,XPRM_TYP_BOOL,1,"|bigint|",bn_isodd},
+         {"getasreal",1422,XPRM_TYP_REAL,1,"|bigint|",bn_asreal},
+         {"@&",1423,XPRM_TYP_EXTN,1,"int64:|bigint|",bn_asi64}
 	};
 
                                      /* Table of types */
 static XPRMdsotyp tabtyp[]=
         {
-         {"int64",1,XPRM_DTYP_PNCTX|XPRM_DTYP_RFCNT|XPRM_DTYP_APPND|XPRM_DTYP_TFBIN|XPRM_DTYP_ORD|XPRM_DTYP_CONST,bi_create,bi_delete,bi_tostr,bi_fromstr,bi_copy,bi_compare}
+         {"int64",1,XPRM_DTYP_PNCTX|XPRM_DTYP_RFCNT|XPRM_DTYP_APPND|XPRM_DTYP_TFBIN|XPRM_DTYP_ORD|XPRM_DTYP_CONST,bi_create,bi_delete,bi_tostr,bi_fromstr,bi_copy,bi_compare},
+         {"bigint",2,XPRM_DTYP_PNCTX|XPRM_DTYP_RFCNT|XPRM_DTYP_APPND|XPRM_DTYP_TFBIN|XPRM_DTYP_ORD|XPRM_DTYP_CONST,bn_create,bn_delete,bn_tostr,bn_fromstr,bn_copy,bn_compare}
         };
 
                                      /* Table of services */
 static struct Mmath_imci imci=
 	{
 	 imci_getint64val,
-	 imci_setint64val
+	 imci_setint64val,
+	 imci_getint64vec,
+	 imci_setint64vec,
+	 imci_newint64vec
 	};
 static XPRMdsoserv tabserv[]=
         {
@@ -272,15 +369,40 @@ static XPRMdsointer dsointer=
 
 static XPRMnifct mm;             /* For storing Mosel NI function table */
 
+#define BI_PGSHIFT 10                   /* int64s per page: 1024 */
+#define BI_PGSIZE (1<<BI_PGSHIFT)
+#define BI_PGMASK (BI_PGSIZE-1)
+
+typedef struct                  /* Page of int64s */
+        {
+         int64_t value[BI_PGSIZE];       /* values of int64s */
+         unsigned int refcnt[BI_PGSIZE]; /* refcnts of int64s */
+         int nbused;            /* number of int64s in use */
+         int nbinit;            /* number of entries used at least once */
+         int firstfree;         /* first free entry (-1 if none) */
+         int prev,next;         /* list of pages with free entries */
+        } s_bipage;
+
 typedef struct MathCtx            /* Module context */
         {
-         int nbmaxi64;          /* current size of the arrays */
+         int nbpages;           /* current size of the page table */
+         int nbpgalloc;         /* number of allocated pages */
          int nbi64;             /* current number of int64s */
-         size_t firstfree;      /* first free int64 */
-         unsigned int *refcnt;  /* refcnts of int64s */
-         int64_t *value;        /* values of int64s */
+         int pgfree;            /* first page with free entries (-1 if none) */
+         s_bipage **page;       /* page table (NULL for released pages) */
+         s_bipage *spare;       /* released page kept for reuse */
         } s_mathctx;
 
+typedef struct                  /* Arbitrary precision integer */
+        {
+         int refcnt;            /* reference counter */
+         int cst;               /* whether it is a constant */
+         int sign;              /* 1 if negative */
+         int n;                 /* number of limbs (0 for 0) */
+         int size;              /* allocated number of limbs */
+         uint32_t *d;           /* limbs (least significant first) */
+        } s_bigint;
+
 /************************************************/
 /* Initialize the library just after loading it */
 /************************************************/
@@ -308,6 +430,56 @@ static int chkerror(XPRMcontext ctx,const char *fct)
   return XPRM_RT_OK;
 }
 
+/******************************************************/
+/* Check whether 2 arrays have the same indexing sets */
+/* (the same sets or sets with identical contents and */
+/* numbering such that index tuples are shared)       */
+/******************************************************/
+static int samesets(XPRMcontext ctx,XPRMarray a1,XPRMarray a2)
+{
+ XPRMset sets1[15],sets2[15];
+ XPRMalltypes v1,v2;
+ int dim,k,i,n,t;
+
+ dim=mm->getarrdim(a1);
+ if((dim>15)||(mm->getarrdim(a2)!=dim))
+  return 0;
+ mm->getarrsets(a1,sets1);
+ mm->getarrsets(a2,sets2);
+ for(k=0;k<dim;k++)
+  if(sets1[k]!=sets2[k])
+  {
+   n=mm->getsetsize(sets1[k]);
+   t=XPRM_TYP(mm->getsettype(sets1[k]));
+   i=mm->getfirstsetndx(sets1[k]);
+   if((mm->getsetsize(sets2[k])!=n)||
+      (XPRM_TYP(mm->getsettype(sets2[k]))!=t)||
+      (mm->getfirstsetndx(sets2[k])!=i))
+    return 0;
+   for(;n>0;i++,n--)
+   {
+    mm->getelsetval(ctx,sets1[k],i,&v1);
+    mm->getelsetval(ctx,sets2[k],i,&v2);
+    switch(t)
+    {
+     case XPRM_TYP_INT:
+     case XPRM_TYP_BOOL:
+       if(v1.integer!=v2.integer) return 0;
+       break;
+     case XPRM_TYP_REAL:
+       if(v1.real!=v2.real) return 0;
+       break;
+     case XPRM_TYP_STRING:
+       if(strcmp(v1.string,v2.string)) return 0;
+       break;
+     default:
+       if(v1.ref!=v2.ref) return 0;
+    }
+   }
+  }
+ return 1;
+}
+
 /***********/
 /* Tangent */
 /***********/
@@ -657,6 +829,182 @@ static int ma_yn(XPRMcontext ctx,void *libctx)
  return XPRM_RT_OK;
 }
 
+/******** Element-wise evaluation over arrays ********/
+
+/* The entries of the argument arrays are read by blocks of MA_ABUF */
+/* values (with their indices) that are evaluated in a single loop  */
+/* before being stored into the result array: errno is checked once */
+/* per call.                                                        */
+#define MA_ABUF 256
+
+/*******************************************************************/
+/* Common routine: R(i):=f1(A(i)) or R(i):=f2(A(i),B(i)) for all   */
+/* entries i of A (entries missing in B count as 0); all arrays    */
+/* must have the same indexing sets (checked before R is modified) */
+/*******************************************************************/
+static int ma_aeval(XPRMcontext ctx,double (*f1)(double),
+                double (*f2)(double,double),const char *fct)
+{
+ XPRMarray a,b,r;
+ XPRMalltypes v;
+ double x[MA_ABUF],y[MA_ABUF];
+ int ind[MA_ABUF*15];
+ int indices[15];
+ int n,i,dim,done,rts;
+
+ a=XPRM_POP_REF(ctx);
+ b=(f2!=NULL)?XPRM_POP_REF(ctx):NULL;
+ r=XPRM_POP_REF(ctx);
+ if((a==NULL)||(r==NULL)||((f2!=NULL)&&(b==NULL)))
+  return XPRM_RT_OK;
+ dim=mm->getarrdim(a);
+ if(!samesets(ctx,a,r)||((b!=NULL)&&!samesets(ctx,a,b)))
+ {
+  mm->dispmsg(ctx,"Math: Invalid array in '%s'.\n",fct);
+  return XPRM_RT_ERROR;
+ }
+ rts=XPRM_RT_OK;
+ errno=0;
+ done=mm->getfirstarrtruentry(a,indices);
+ while(!done)
+ {
+  for(n=0;!done&&(n<MA_ABUF);n++)
+  {
+   memcpy(ind+n*dim,indices,dim*sizeof(int));
+   v.real=0;
+   mm->getarrval(a,indices,&v);
+   x[n]=v.real;
+   if(b!=NULL)
+   {
+    v.real=0;
+    mm->getarrval(b,indices,&v);
+    y[n]=v.real;
+   }
+   done=mm->getnextarrtruentry(a,indices);
+  }
+  if(b==NULL)
+   for(i=0;i<n;i++)
+    x[i]=f1(x[i]);
+  else
+   for(i=0;i<n;i++)
+    x[i]=f2(x[i],y[i]);
+  for(i=0;i<n;i++)
+   if(mm->setarrvalreal(ctx,r,ind+i*dim,x[i]))
+    rts=XPRM_RT_ERROR;
+ }
+ if(rts!=XPRM_RT_OK)
+ {
+  mm->dispmsg(ctx,"Math: Invalid array in '%s'.\n",fct);
+  return rts;
+ }
+ else
+  return chkerror(ctx,fct);
+}
+
+/*******************************/
+/* tan(array,array): R:=tan(A) */
+/*******************************/
+static int ma_tan_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,tan,NULL,"tan");
+}
+
+/*************************************/
+/* arcsin(array,array): R:=arcsin(A) */
+/*************************************/
+static int ma_asin_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,asin,NULL,"arcsin");
+}
+
+/*************************************/
+/* arccos(array,array): R:=arccos(A) */
+/*************************************/
+static int ma_acos_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,acos,NULL,"arccos");
+}
+
+/*************************************************/
+/* arctan2(array,array,array): R:=arctan2(A,B)   */
+/*************************************************/
+static int ma_atan2_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,NULL,atan2,"arctan2");
+}
+
+/*********************************/
+/* cosh(array,array): R:=cosh(A) */
+/*********************************/
+static int ma_cosh_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,cosh,NULL,"cosh");
+}
+
+/*********************************/
+/* sinh(array,array): R:=sinh(A) */
+/*********************************/
+static int ma_sinh_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,sinh,NULL,"sinh");
+}
+
+/*********************************/
+/* tanh(array,array): R:=tanh(A) */
+/*********************************/
+static int ma_tanh_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,tanh,NULL,"tanh");
+}
+
+/***************************************/
+/* arccosh(array,array): R:=arccosh(A) */
+/***************************************/
+static int ma_acosh_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,acosh,NULL,"arccosh");
+}
+
+/***************************************/
+/* arcsinh(array,array): R:=arcsinh(A) */
+/***************************************/
+static int ma_asinh_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,asinh,NULL,"arcsinh");
+}
+
+/***************************************/
+/* arctanh(array,array): R:=arctanh(A) */
+/***************************************/
+static int ma_atanh_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,atanh,NULL,"arctanh");
+}
+
+/*********************************************/
+/* hypot(array,array,array): R:=hypot(A,B)   */
+/*********************************************/
+static int ma_hypot_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,NULL,hypot,"hypot");
+}
+
+/***********************************/
+/* log1p(array,array): R:=log1p(A) */
+/***********************************/
+static int ma_log1p_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,log1p,NULL,"log1p");
+}
+
+/*********************************/
+/* cbrt(array,array): R:=cbrt(A) */
+/*********************************/
+static int ma_cbrt_a(XPRMcontext ctx,void *libctx)
+{
+ return ma_aeval(ctx,cbrt,NULL,"cbrt");
+}
+
 /******************** Services ********************/
 
 /***********************************/
@@ -677,6 +1025,7 @@ static void *ma_reset(XPRMcontext ctx,void *libctx,int version)
   else
   {
    memset(mactx,0,sizeof(s_mathctx));
+   mactx->pgfree=-1;
    return mactx;
   }
  }
@@ -684,7 +1033,7 @@ static void *ma_reset(XPRMcontext ctx,void *libctx,int version)
  {
   mactx=libctx;
 
-  free(mactx->value);
+  bi_freeall(mactx);
   free(mactx);
   return NULL;
  }
@@ -715,15 +1064,26 @@ static void ma_updvers(int type,int what,int *v)
  {
   case XPRM_UPDV_INIT: if(*v <XPRM_MKVER(0,0,3)) *v=XPRM_MKVER(0,0,3); break;
   case XPRM_UPDV_FUNC:
+	if((*v<XPRM_MKVER(1,1,0))&&(what>=1060)&&(what<=1072))
+	{ *v=XPRM_MKVER(1,1,0); return; }	/* array versions */
 	if(*v<XPRM_MKVER(1,0,0))
 	{
 	 if((what>=1300)&&(what<=1374))	/* int64 routines */
 	 { *v=XPRM_MKVER(1,0,0); return; }
 	}
+	if(*v<XPRM_MKVER(1,1,0))
+	{
+	 if((what>=1380)&&(what<=1383))	/* int64 array reductions */
+	 { *v=XPRM_MKVER(1,1,0); return; }
+	 if((what>=1400)&&(what<=1423))	/* bigint routines */
+	 { *v=XPRM_MKVER(1,1,0); return; }
+	}
 	break;
   case XPRM_UPDV_TYPE:
 	if(*v<XPRM_MKVER(1,0,0))
 	 *v=XPRM_MKVER(1,0,0);
+	if((what==2)&&(*v<XPRM_MKVER(1,1,0)))	/* bigint */
+	 *v=XPRM_MKVER(1,1,0);
 	break;
  }
 }
@@ -738,12 +1098,17 @@ static size_t ma_memuse(XPRMcontext ctx,void *libctx,void *ref,int code)
  switch(code)
  {
   case 0:
-    return sizeof(s_mathctx)+mactx->nbmaxi64*(sizeof(int)+sizeof(int64_t));
+    return sizeof(s_mathctx)+mactx->nbpages*sizeof(s_bipage *)+
+           mactx->nbpgalloc*sizeof(s_bipage);
   case 1:
     return sizeof(int64_t)+sizeof(int);
+  case 2:
+    return sizeof(s_bigint)+
+           ((ref!=NULL)?((s_bigint *)ref)->size*sizeof(uint32_t):0);
   default:
     return -1;
  }
 }
 
 #include "bigint.c"
+#include "bignum.c"
@@ -32,5 +32,9 @@ typedef struct Mmath_imci
 	{
 	 int64_t (*getint64val)(struct Vimactx *ctx,struct MathCtx *mactx,void *ref);
 	 int (*setint64val)(struct Vimactx *ctx,struct MathCtx *mactx,void *ref,int64_t v);
+				/* Bulk access (n references): since 1.1.0 */
+	 int (*getint64vec)(struct Vimactx *ctx,struct MathCtx *mactx,void **refs,int n,int64_t *v);
+	 int (*setint64vec)(struct Vimactx *ctx,struct MathCtx *mactx,void **refs,int n,const int64_t *v);
+	 int (*newint64vec)(struct Vimactx *ctx,struct MathCtx *mactx,void **refs,int n,const int64_t *v);
 	} *mmath_imci;
 #endif
@@ -82,7 +82,7 @@ gcc -Wall -o random.dso -shared -D_REENTRANT -I${XPRESSDIR}/include random.c -lm
  *      Pascal(n, p)      x = 0,...     n*p/(1-p)    n*p/((1-p)*(1-p))
  *      Poisson(m)        x = 0,...     m            m
  * 
- * and seven continuous distributions
+ * and nine continuous distributions
  *
  *      Uniform(a, b)     a < x < b     (a + b)/2    (b - a)*(b - a)/12 
  *      Exponential(m)    x > 0         m            m*m
@@ -91,12 +91,17 @@ gcc -Wall -o random.dso -shared -D_REENTRANT -I${XPRESSDIR}/include random.c -lm
  *      Lognormal(a, b)   x > 0            see below
  *      Chisquare(n)      x > 0         n            2*n 
  *      Student(n)        all x         0  (n > 1)   n/(n - 2)   (n > 2)
+ *      Gamma(k, t)       x > 0         k*t          k*t*t
+ *      Beta(a, b)        0 < x < 1     a/(a+b)      a*b/((a+b)*(a+b)*(a+b+1))
  *
  * For the a Lognormal(a, b) random variable, the mean and variance are
  *
  *                        mean = exp(a + 0.5*b*b)
  *                    variance = (exp(b*b) - 1) * exp(2*a + b*b)
  *
+ * Truncnormal(m, s, lo, hi) and Truncexponential(m, lo, hi) are the
+ * Normal(m, s) and Exponential(m) distributions restricted to [lo, hi].
+ *
  * Name              : rvgs.c  (Random Variate GeneratorS)
  * Author            : Steve Park & Dave Geyer
  * Language          : ANSI C
@@ -105,33 +110,155 @@ gcc -Wall -o random.dso -shared -D_REENTRANT -I${XPRESSDIR}/include random.c -lm
  * --------------------------------------------------------------------------
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <limits.h>
 #define MM_NICOMPAT 3000000
 #include "xprm_ni.h"
 
+/* SIMD versions of the state refill: SSE2 is part of the x86-64 baseline */
+/* while AVX2 is selected at runtime (only with gcc/clang)                */
+#if defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&(_M_IX86_FP>=2))
+#define RND_SSE2
+#include <emmintrin.h>
+#endif
+#if (defined(__GNUC__)||defined(__clang__))&&(defined(__x86_64__)||defined(__i386__))
+#define RND_AVX2
+#include <immintrin.h>
+#endif
+
 /* Period parameters */  
 #define N 624
 #define M 397
 #define MATRIX_A 0x9908b0dfU    /* constant vector a */
 #define UPPER_MASK 0x80000000U  /* most significant w-r bits */
 #define LOWER_MASK 0x7fffffffU  /* least significant r bits */
+#define JP_MEXP 19937           /* degree of the characteristic polynomial */
+#define JP_NW ((JP_MEXP+63)/64) /* 64bit words for a polynomial mod phi */
 
 /**** Structures used by this module ****/
 typedef struct
 	{
 	 unsigned int mt[N];	/* the array for the state vector  */
+	 unsigned int out[N];	/* tempered outputs of the current block */
 	 int mti;		/* mti==N+1 means mt[N] is not initialized */
+	 int options;		/* Module parameters (see OPT_*) */
+	 int engine;		/* Generator engine (see ENG_*) */
+	 unsigned long long seed;	/* Last seed (used when changing engine) */
+	 unsigned long long es[4];	/* State of the small-state engines */
+	 unsigned long long mseed;	/* Master seed (64bit) */
+	 unsigned int node;	/* Node number (for seed derivation) */
+	 unsigned int uid;	/* Model ID (for seed derivation) */
 	} s_rndctx;
 
+	/* For decoding 'options' in the module context */
+#define OPT_ZIGGURAT 1		/* Ziggurat for normal & exponential */
+
+	/* Generator engines ('engine' in the module context) */
+#define ENG_MT19937 0		/* Mersenne Twister (default) */
+#define ENG_XOSHIRO 1		/* xoshiro256** */
+#define ENG_PCG64   2		/* PCG64 (XSL-RR 128/64) */
+#define ENG_PHILOX  3		/* Philox4x32-10 (counter based) */
+
+static const char *engnames[]={"mt19937","xoshiro256","pcg64","philox"};
+
+#define ENG_NB (sizeof(engnames)/sizeof(engnames[0]))
+
+static struct              /* Parameters published by this module */
+	{
+	 char *name;
+	 int type;
+	} rndparams[]=
+	{
+	 {"rnd_ziggurat",XPRM_TYP_BOOL|XPRM_CPAR_READ|XPRM_CPAR_WRITE},
+	 {"rnd_engine",XPRM_TYP_STRING|XPRM_CPAR_READ|XPRM_CPAR_WRITE},
+	 {"rnd_seed",XPRM_TYP_INT|XPRM_CPAR_READ|XPRM_CPAR_WRITE}
+	};
+
+#define RND_NBPARAM (sizeof(rndparams)/sizeof(rndparams[0]))
+
+typedef struct              /* Discrete distribution (alias tables) */
+	{
+	 int refcnt;		/* Reference counter */
+	 int n;			/* Number of outcomes (0 if not set) */
+	 double *prob;		/* Probability to keep the selected column */
+	 int *alias;		/* Alternative outcome of each column */
+	 int *val;		/* Index values of the outcomes */
+	} s_ddist;
+
+typedef struct              /* Low-discrepancy sequence */
+	{
+	 int refcnt;		/* Reference counter */
+	 int kind;		/* Type of sequence (see QMC_*) */
+	 int dim;		/* Dimension (0 if not set) */
+	 unsigned int n;	/* Number of points generated */
+	 unsigned int *v;	/* Sobol: direction numbers (32 per dim.) */
+				/* Halton: base and digit multiplier */
+	 unsigned int *x;	/* Sobol: current point */
+	} s_qmcseq;
+
+	/* Types of sequences ('kind' in s_qmcseq) */
+#define QMC_SOBOL  0		/* Sobol (Joe-Kuo direction numbers) */
+#define QMC_HALTON 1		/* Scrambled Halton */
+
+static const char *qmcnames[]={"sobol","halton"};
+
+#define QMC_NB (sizeof(qmcnames)/sizeof(qmcnames[0]))
+#define QMC_MAXDIM 1000		/* Largest dimension of a sequence */
+
+typedef struct              /* Multivariate normal distribution */
+	{
+	 int refcnt;		/* Reference counter */
+	 int n;			/* Dimension (0 if not set) */
+	 int tri;		/* Whether f is lower triangular */
+	 double *f;		/* Factor of the covariance matrix (n x n) */
+	 double *mu;		/* Mean vector */
+	} s_mvnorm;
+
+#define MV_BLOCK 8192		/* Block size (in values) for sampling */
+
+	/* Sampling designs (see smp_fill) */
+#define SMP_LHS   0		/* Latin hypercube */
+#define SMP_STRAT 1		/* Stratified (regular grid) */
+#define SMP_ANTI  2		/* Antithetic pairs */
+
 /**** Function prototypes ****/
 static int chkres(int);
 static void *rnd_reset(XPRMcontext ctx,void *libctx,int version);
+static int rnd_findparam(const char *name,int *type,int why,XPRMcontext ctx,
+                void *libctx);
+static void *rnd_nextparam(void *ref,const char **name,const char **desc,
+                int *type);
+static int rnd_getpar(XPRMcontext ctx,void *libctx);
+static int rnd_setpar(XPRMcontext ctx,void *libctx);
 static void init_genrand(s_rndctx *rndctx,unsigned int s);
+static void rnd_seed(s_rndctx *rndctx,unsigned long long s);
+static unsigned long long rnd_derive(s_rndctx *rndctx);
+static void eng_stream(s_rndctx *rndctx,unsigned int k);
+static void eng_refill(s_rndctx *rndctx);
+static unsigned long long splitmix64(unsigned long long *x);
+static void philox4x32(const unsigned int *ctr,const unsigned int *key,
+                unsigned int *out);
 static int rnd_setseed(XPRMcontext ctx,void *libctx);
 static int rnd_setseeda(XPRMcontext ctx,void *libctx);
+static int rnd_setstream(XPRMcontext ctx,void *libctx);
+static unsigned char *st_put(unsigned char *p,unsigned long long v,int nb);
+static const unsigned char *st_get(const unsigned char *p,
+                unsigned long long *v,int nb);
+static int rnd_getstate(XPRMcontext ctx,void *libctx);
+static int rnd_setstate(XPRMcontext ctx,void *libctx);
+static void jp_jumppoly(unsigned long long *p,unsigned int k,int e);
+static void mt_jump(s_rndctx *rndctx,const unsigned long long *p);
 static unsigned int genrand_int32(s_rndctx *rndctx);
+static void mt_refill_c(s_rndctx *rndctx);
+#ifdef RND_SSE2
+static void mt_refill_sse2(s_rndctx *rndctx);
+#endif
+#ifdef RND_AVX2
+static void mt_refill_avx2(s_rndctx *rndctx);
+#endif
 static int rnd_int32(XPRMcontext ctx,void *libctx);
 static int rnd_int32b(XPRMcontext ctx,void *libctx);
 static int rnd_int31(XPRMcontext ctx,void *libctx);
@@ -144,28 +271,95 @@ static int rnd_realb(XPRMcontext ctx,void *libctx);
 
 static int bernoulli(s_rndctx *rndctx,double p);
 static int rnd_bernoulli(XPRMcontext ctx,void *libctx);
+static int binomial(s_rndctx *rndctx,int n,double p);
 static int rnd_binomial(XPRMcontext ctx,void *libctx);
 static int geometric(s_rndctx *rndctx,double p);
 static int rnd_geometric(XPRMcontext ctx,void *libctx);
+static int pascal(s_rndctx *rndctx,int n,double p);
 static int rnd_pascal(XPRMcontext ctx,void *libctx);
 static double exponential(s_rndctx *rndctx,double m);
 static int rnd_exponential(XPRMcontext ctx,void *libctx);
+static void zig_init(void);
+static double zig_normal(s_rndctx *rndctx);
+static double zig_exponential(s_rndctx *rndctx);
+static int poisson(s_rndctx *rndctx,double m);
 static int rnd_poisson(XPRMcontext ctx,void *libctx);
+static double erlang(s_rndctx *rndctx,int n,double b);
 static int rnd_erlang(XPRMcontext ctx,void *libctx);
 static double normal(s_rndctx *rndctx,double m,double s);
 static int rnd_normal(XPRMcontext ctx,void *libctx);
+static double lognormal(s_rndctx *rndctx,double a,double b);
+static double gammadev(s_rndctx *rndctx,double k);
+static int rnd_gamma(XPRMcontext ctx,void *libctx);
+static double betadev(s_rndctx *rndctx,double a,double b);
+static int rnd_beta(XPRMcontext ctx,void *libctx);
+static double loggam(double x);
+static double normal_icdf(double p);
+static double truncstd(s_rndctx *rndctx,double a,double b);
+static double truncnormal(s_rndctx *rndctx,double m,double s,double lo,
+                double hi);
+static int rnd_truncnormal(XPRMcontext ctx,void *libctx);
+static double truncexponential(s_rndctx *rndctx,double m,double lo,
+                double hi);
+static int rnd_truncexponential(XPRMcontext ctx,void *libctx);
 static int rnd_lognormal(XPRMcontext ctx,void *libctx);
 static double chisquare(s_rndctx *rndctx,int n);
 static int rnd_chisquare(XPRMcontext ctx,void *libctx);
+static double student(s_rndctx *rndctx,int n);
 static int rnd_student(XPRMcontext ctx,void *libctx);
+static int rnd_creal(XPRMcontext ctx,void *libctx);
+static int rnd_cnormal(XPRMcontext ctx,void *libctx);
+
+static int rnd_fill0(XPRMcontext ctx,void *libctx);
+static int rnd_fill1(XPRMcontext ctx,void *libctx);
+static int rnd_fill2(XPRMcontext ctx,void *libctx);
+static int rnd_filli0(XPRMcontext ctx,void *libctx);
+static int rnd_filli1(XPRMcontext ctx,void *libctx);
+static int rnd_filli2(XPRMcontext ctx,void *libctx);
+static int rnd_fill(XPRMcontext ctx,s_rndctx *rndctx,int isint,int nbpar);
+static void *dd_create(XPRMcontext ctx,void *libctx,void *todup,int typnum);
+static void dd_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum);
+static int dd_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,
+                int len,int typnum);
+static int dd_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,
+                int typnum);
+static int dd_new(XPRMcontext ctx,void *libctx);
+static int dd_discrete(XPRMcontext ctx,void *libctx);
+static int dd_fill(XPRMcontext ctx,void *libctx);
+static void *qs_create(XPRMcontext ctx,void *libctx,void *todup,int typnum);
+static void qs_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum);
+static int qs_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,
+                int len,int typnum);
+static int qs_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,
+                int typnum);
+static int qs_new(XPRMcontext ctx,void *libctx);
+static int qs_fill(XPRMcontext ctx,void *libctx);
+static void *mv_create(XPRMcontext ctx,void *libctx,void *todup,int typnum);
+static void mv_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum);
+static int mv_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,
+                int len,int typnum);
+static int mv_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,
+                int typnum);
+static int mv_new1(XPRMcontext ctx,void *libctx);
+static int mv_new2(XPRMcontext ctx,void *libctx);
+static int mv_fill(XPRMcontext ctx,void *libctx);
+static int smp_fill(XPRMcontext ctx,void *libctx,int kind,const char *name);
+static int rnd_lhsample(XPRMcontext ctx,void *libctx);
+static int rnd_stratsample(XPRMcontext ctx,void *libctx);
+static int rnd_antisample(XPRMcontext ctx,void *libctx);
 static int rnd_math_error(XPRMcontext ctx,const char *name);
 
 /**** Structures for passing info to Mosel ****/
 /* Subroutines */
 static XPRMdsofct tabfct[]=
         {
+         {"",XPRM_FCT_GETPAR,XPRM_TYP_NOT,0,NULL,rnd_getpar},
+         {"",XPRM_FCT_SETPAR,XPRM_TYP_NOT,0,NULL,rnd_setpar},
          {"setmtrandseed",1000,XPRM_TYP_NOT,1,"i",rnd_setseed},
          {"setmtrandseed",1001,XPRM_TYP_NOT,1,"A.i",rnd_setseeda},
+         {"setmtrandstream",1010,XPRM_TYP_NOT,2,"ii",rnd_setstream},
+         {"getmtrandstate",1011,XPRM_TYP_NOT,1,"s",rnd_getstate},
+         {"setmtrandstate",1012,XPRM_TYP_NOT,1,"s",rnd_setstate},
          {"mtrand_int",1002,XPRM_TYP_INT,0,NULL,rnd_int32},
          {"mtrand_int",1003,XPRM_TYP_INT,2,"ii",rnd_int32b},
          {"equilikely",1003,XPRM_TYP_INT,2,"ii",rnd_int32b},
@@ -187,12 +381,51 @@ static XPRMdsofct tabfct[]=
          {"normal",1107,XPRM_TYP_REAL,2,"rr",rnd_normal},
          {"pascal",1108,XPRM_TYP_INT,2,"ir",rnd_pascal},
          {"poisson",1109,XPRM_TYP_INT,1,"r",rnd_poisson},
-         {"student",1110,XPRM_TYP_REAL,1,"i",rnd_student}
+         {"student",1110,XPRM_TYP_REAL,1,"i",rnd_student},
+         {"beta",1111,XPRM_TYP_REAL,2,"rr",rnd_beta},
+         {"gamma",1112,XPRM_TYP_REAL,2,"rr",rnd_gamma},
+         {"truncnormal",1113,XPRM_TYP_REAL,4,"rrrr",rnd_truncnormal},
+         {"truncexponential",1114,XPRM_TYP_REAL,3,"rrr",rnd_truncexponential},
+
+         {"crand_real",1150,XPRM_TYP_REAL,2,"ii",rnd_creal},
+         {"crand_normal",1151,XPRM_TYP_REAL,4,"iirr",rnd_cnormal},
+
+         {"fillrandom",1200,XPRM_TYP_NOT,2,"A.rs",rnd_fill0},
+         {"fillrandom",1201,XPRM_TYP_NOT,3,"A.rsr",rnd_fill1},
+         {"fillrandom",1202,XPRM_TYP_NOT,4,"A.rsrr",rnd_fill2},
+         {"fillrandom",1203,XPRM_TYP_NOT,2,"A.is",rnd_filli0},
+         {"fillrandom",1204,XPRM_TYP_NOT,3,"A.isr",rnd_filli1},
+         {"fillrandom",1205,XPRM_TYP_NOT,4,"A.isrr",rnd_filli2},
+         {"fillrandom",1206,XPRM_TYP_NOT,2,"A.i|discretedist|",dd_fill},
+         {"fillrandom",1207,XPRM_TYP_NOT,2,"A.r|qmcseq|",qs_fill},
+         {"fillrandom",1208,XPRM_TYP_NOT,2,"A.r|mvnormal|",mv_fill},
+
+         {"lhsample",1250,XPRM_TYP_NOT,3,"A.rii",rnd_lhsample},
+         {"stratsample",1251,XPRM_TYP_NOT,3,"A.rii",rnd_stratsample},
+         {"antisample",1252,XPRM_TYP_NOT,3,"A.rii",rnd_antisample},
+
+         {"@&",1300,XPRM_TYP_EXTN,1,"discretedist:A.r",dd_new},
+         {"discrete",1301,XPRM_TYP_INT,1,"|discretedist|",dd_discrete},
+
+         {"@&",1310,XPRM_TYP_EXTN,2,"qmcseq:si",qs_new},
+
+         {"@&",1320,XPRM_TYP_EXTN,1,"mvnormal:A.r",mv_new1},
+         {"@&",1321,XPRM_TYP_EXTN,2,"mvnormal:A.rA.r",mv_new2}
 	};
 
+/* Types */
+static XPRMdsotyp tabtyp[]=
+        {
+         {"discretedist",1,XPRM_DTYP_PNCTX|XPRM_DTYP_RFCNT,dd_create,dd_delete,dd_tostr,NULL,dd_copy,NULL},
+         {"qmcseq",2,XPRM_DTYP_PNCTX|XPRM_DTYP_RFCNT,qs_create,qs_delete,qs_tostr,NULL,qs_copy,NULL},
+         {"mvnormal",3,XPRM_DTYP_PNCTX|XPRM_DTYP_RFCNT,mv_create,mv_delete,mv_tostr,NULL,mv_copy,NULL}
+        };
+
 /* Services */
 static XPRMdsoserv tabserv[]=
         {
+         {XPRM_SRV_PARAM,(void *)rnd_findparam},
+         {XPRM_SRV_PARLST,(void *)rnd_nextparam},
          {XPRM_SRV_RESET,(void *)rnd_reset},
 	 {XPRM_SRV_CHKRES,(void*)chkres}
         };
@@ -202,11 +435,13 @@ static XPRMdsointer dsointer=
         { 
          0,NULL,
          sizeof(tabfct)/sizeof(XPRMdsofct),tabfct,
-         0,NULL,
+         sizeof(tabtyp)/sizeof(XPRMdsotyp),tabtyp,
          sizeof(tabserv)/sizeof(XPRMdsoserv),tabserv
         };
 
 static XPRMnifct mm;             /* For storing Mosel NI function table */
+                                 /* Block refill routine (set at init) */
+static void (*mt_refill)(s_rndctx *rndctx)=mt_refill_c;
 
 /************************************************/
 /* Initialize the library just after loading it */
@@ -218,6 +453,15 @@ DSO_INIT random_init(XPRMnifct nifct, int *interver,int *libver, XPRMdsointer **
  *libver=XPRM_MKVER(0,0,1);     /* The version of the module: 0.0.1 */
  *interf=&dsointer;             /* Our interface */
 
+#ifdef RND_SSE2
+ mt_refill=mt_refill_sse2;
+#endif
+#ifdef RND_AVX2
+ __builtin_cpu_init();
+ if(__builtin_cpu_supports("avx2"))
+  mt_refill=mt_refill_avx2;
+#endif
+ zig_init();
  return 0;
 }
 
@@ -229,12 +473,56 @@ DSO_INIT random_init(XPRMnifct nifct, int *interver,int *libver, XPRMdsointer **
 static int chkres(int r)
 { return 0; }
 
+/****************************/
+/* Find a control parameter */
+/****************************/
+static int rnd_findparam(const char *name,int *type,int why,XPRMcontext ctx,
+                void *libctx)
+{
+ int n;
+
+ for(n=0;n<RND_NBPARAM;n++)
+ {
+  if(strcmp(name,rndparams[n].name)==0)
+  {
+   *type=rndparams[n].type;
+   return n;
+  }
+ }
+
+ return -1;
+}
+
+/*********************************************/
+/* Return the next parameter for enumeration */
+/*********************************************/
+static void *rnd_nextparam(void *ref,const char **name,const char **desc,
+                int *type)
+{
+ size_t cst;
+
+ cst=(size_t)ref;
+ if(cst>=RND_NBPARAM)
+  return NULL;
+ else
+ {
+  *name=rndparams[cst].name;
+  *type=rndparams[cst].type;
+  *desc=NULL;
+  return (void *)(cst+1);
+ }
+}
+
 /**************************************/
 /* Reset the random module for a run  */
 /**************************************/
+/* The generator is seeded from the master seed (environment variable */
+/* MOSEL_RNDSEED) when it is defined, from the clock otherwise.       */
 static void *rnd_reset(XPRMcontext ctx,void *libctx,int version)
 {
  s_rndctx *rndctx;
+ XPRMalltypes id;
+ const char *env;
  int jdn,t;
 
  if(libctx==NULL)               /* libctx==NULL => initialisation */
@@ -246,8 +534,20 @@ static void *rnd_reset(XPRMcontext ctx,void *libctx,int version)
    return NULL;
   }
   memset(rndctx,0,sizeof(s_rndctx));
-  mm->time(ctx,&jdn,&t,XPRM_TIME_LOCAL);
-  init_genrand(rndctx,jdn*t);
+  if(mm->getmodprop(ctx,XPRM_PROP_ID,&id)==0)
+   rndctx->uid=(unsigned int)id.integer;
+  if((env=getenv("MOSEL_RNDNODE"))!=NULL)
+   rndctx->node=(unsigned int)strtoul(env,NULL,0);
+  if((env=getenv("MOSEL_RNDSEED"))!=NULL)
+  {
+   rndctx->mseed=strtoull(env,NULL,0);
+   rnd_seed(rndctx,rnd_derive(rndctx));
+  }
+  else
+  {
+   mm->time(ctx,&jdn,&t,XPRM_TIME_LOCAL);
+   rnd_seed(rndctx,(unsigned int)(jdn*t));
+  }
   return rndctx;
  }
  else                           /* otherwise release the resources we use */
@@ -259,6 +559,77 @@ static void *rnd_reset(XPRMcontext ctx,void *libctx,int version)
 
 /******** Functions implementing subroutines ********/
 
+/*******************************/
+/* Getting a control parameter */
+/*******************************/
+static int rnd_getpar(XPRMcontext ctx,void *libctx)
+{
+ s_rndctx *rndctx;
+ int n;
+
+ rndctx=libctx;
+ n=XPRM_POP_INT(ctx);
+ switch(n)
+ {
+  case 0:
+   XPRM_PUSH_INT(ctx,(rndctx->options&OPT_ZIGGURAT)?1:0);
+   break;
+  case 1:
+   XPRM_PUSH_REF(ctx,(char *)engnames[rndctx->engine]);
+   break;
+  case 2:
+   XPRM_PUSH_INT(ctx,(int)rndctx->mseed);   /* Lower 32 bits */
+   break;
+  default:
+   mm->dispmsg(ctx,"RANDOM: Wrong control parameter number.\n");
+   return XPRM_RT_ERROR;
+ }
+ return XPRM_RT_OK;
+}
+
+/*******************************/
+/* Setting a control parameter */
+/*******************************/
+static int rnd_setpar(XPRMcontext ctx,void *libctx)
+{
+ s_rndctx *rndctx;
+ const char *ename;
+ int n,e;
+
+ rndctx=libctx;
+ n=XPRM_POP_INT(ctx);
+ switch(n)
+ {
+  case 0:
+    rndctx->options=XPRM_POP_INT(ctx)?(rndctx->options|OPT_ZIGGURAT):(rndctx->options&~OPT_ZIGGURAT);
+    break;
+  case 1:
+    ename=XPRM_POP_REF(ctx);
+    for(e=0;e<ENG_NB;e++)
+     if((ename!=NULL)&&(strcmp(ename,engnames[e])==0))
+      break;
+    if(e>=ENG_NB)
+    {
+     mm->dispmsg(ctx,"RANDOM: unknown engine `%s'.\n",(ename!=NULL)?ename:"");
+     return XPRM_RT_ERROR;
+    }
+    if(e!=rndctx->engine)       /* New engine: initialise with last seed */
+    {
+     rndctx->engine=e;
+     rnd_seed(rndctx,rndctx->seed);
+    }
+    break;
+  case 2:                       /* New master seed: derive the seed */
+    rndctx->mseed=(unsigned long long)(long long)XPRM_POP_INT(ctx);
+    rnd_seed(rndctx,rnd_derive(rndctx));
+    break;
+  default:
+    mm->dispmsg(ctx,"RANDOM: Wrong control parameter number.\n");
+    return XPRM_RT_ERROR;
+ }
+ return XPRM_RT_OK;
+}
+
 /* initializes mt[N] with a seed */
 static void init_genrand(s_rndctx *rndctx,unsigned int s)
 {
@@ -276,10 +647,51 @@ static void init_genrand(s_rndctx *rndctx,unsigned int s)
 
 static int rnd_setseed(XPRMcontext ctx,void *libctx)
 {
- init_genrand(libctx,XPRM_POP_INT(ctx));
+ rnd_seed(libctx,(unsigned int)XPRM_POP_INT(ctx));
  return RT_OK;
 }
 
+/* Initialise the current engine with a seed */
+static void rnd_seed(s_rndctx *rndctx,unsigned long long s)
+{
+ unsigned long long x;
+ unsigned int i;
+
+ rndctx->seed=s;
+ x=s;
+ switch(rndctx->engine)
+ {
+  case ENG_MT19937:
+    init_genrand(rndctx,(unsigned int)s);
+    return;
+  case ENG_XOSHIRO:
+    for(i=0;i<4;i++)
+     rndctx->es[i]=splitmix64(&x);
+    break;
+  case ENG_PCG64:               /* Stream 0 (see eng_stream) */
+    eng_stream(rndctx,0);
+    break;
+  case ENG_PHILOX:              /* Key from seed, counter starts at 0 */
+    rndctx->es[0]=rndctx->es[1]=0;
+    rndctx->es[2]=splitmix64(&x);
+    break;
+ }
+ rndctx->mti=N;                 /* Force a refill at the next draw */
+}
+
+/* Seed of the model derived from the master seed: the model ID and    */
+/* node number are mixed with the master seed through SplitMix64 such  */
+/* that submodels (mmjobs) and tasks on different nodes get distinct   */
+/* but reproducible streams.                                           */
+static unsigned long long rnd_derive(s_rndctx *rndctx)
+{
+ unsigned long long x;
+
+ x=rndctx->mseed;
+ x=splitmix64(&x)^(((unsigned long long)rndctx->node<<32)|rndctx->uid);
+ return splitmix64(&x);
+}
+
 /* initialize by an array with array-length */
 /* init_key is the array for initializing keys */
 /* key_length is its length */
@@ -290,6 +702,7 @@ static int rnd_setseeda(XPRMcontext ctx,void *libctx)
     XPRMarray arrseeds;
     int key_length,dim,indices[15];
     XPRMalltypes init_key;
+    unsigned long long h,x;
     int i, j, k;
 
     rndctx=libctx;
@@ -301,6 +714,19 @@ static int rnd_setseeda(XPRMcontext ctx,void *libctx)
      return RT_ERROR;
     }
 
+    /* Hash of the key: seed of the other engines */
+    h=key_length;
+    mm->getfirstarrtruentry(arrseeds,indices);
+    do {
+        mm->getarrval(arrseeds,indices,&init_key);
+        x=h^(unsigned int)init_key.integer;
+        h=splitmix64(&x);
+    } while(!mm->getnextarrtruentry(arrseeds,indices));
+    if(rndctx->engine!=ENG_MT19937) {
+        rnd_seed(rndctx,h);
+        return RT_OK;
+    }
+
     mm->getfirstarrtruentry(arrseeds,indices);
     init_genrand(rndctx,19650218U);
     i=1;j=0;
@@ -327,414 +753,3782 @@ static int rnd_setseeda(XPRMcontext ctx,void *libctx)
     }
 
     rndctx->mt[0] = 0x80000000U; /* MSB is 1; assuring non-zero initial array */
+    rndctx->seed=h;
     return RT_OK;
 }
 
-/* generates a random number on [0,0xffffffff]-interval */
-static unsigned int genrand_int32(s_rndctx *rndctx)
+/****************************************************************/
+/* Select stream k of a seed: the generator is initialised with */
+/* the seed and then moved k*2^128 outputs ahead (MT19937,      */
+/* xoshiro256**) or switched to stream k (PCG64, Philox)        */
+/****************************************************************/
+static int rnd_setstream(XPRMcontext ctx,void *libctx)
 {
-    unsigned int y;
-    static unsigned int mag01[2]={0x0U, MATRIX_A};
-    /* mag01[x] = x * MATRIX_A  for x=0,1 */
-
-    if (rndctx->mti >= N) { /* generate N words at one time */
-        int kk;
-
-        if (rndctx->mti == N+1)   /* if init_genrand() has not been called, */
-            init_genrand(rndctx,5489U); /* a default initial seed is used */
+ s_rndctx *rndctx;
+ unsigned long long p[2*JP_NW];
+ int seed,k;
 
-        for (kk=0;kk<N-M;kk++) {
-            y = (rndctx->mt[kk]&UPPER_MASK)|(rndctx->mt[kk+1]&LOWER_MASK);
-            rndctx->mt[kk] = rndctx->mt[kk+M] ^ (y >> 1) ^ mag01[y & 0x1U];
-        }
-        for (;kk<N-1;kk++) {
-            y = (rndctx->mt[kk]&UPPER_MASK)|(rndctx->mt[kk+1]&LOWER_MASK);
-            rndctx->mt[kk] = rndctx->mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & 0x1U];
-        }
-        y = (rndctx->mt[N-1]&UPPER_MASK)|(rndctx->mt[0]&LOWER_MASK);
-        rndctx->mt[N-1] = rndctx->mt[M-1] ^ (y >> 1) ^ mag01[y & 0x1U];
+ rndctx=libctx;
+ seed=XPRM_POP_INT(ctx);
+ k=XPRM_POP_INT(ctx);
+ if(k<0)
+  return rnd_math_error(ctx,"setmtrandstream");
+ else
+ {
+  rnd_seed(rndctx,(unsigned int)seed);
+  if(k>0)
+  {
+   if(rndctx->engine==ENG_MT19937)
+   {
+    jp_jumppoly(p,k,128);
+    mt_jump(rndctx,p);
+   }
+   else
+    eng_stream(rndctx,k);
+  }
+  return RT_OK;
+ }
+}
 
-        rndctx->mti = 0;
-    }
-  
-    y = rndctx->mt[rndctx->mti++];
+/**** Generator state snapshot ****/
+/* Binary layout (all values little endian): magic, format version,      */
+/* engine, mti (4 bytes), seed and es[4] (8 bytes each) followed by N    */
+/* 32bit words: the state vector for MT19937 (its tempered outputs are   */
+/* recomputed on restore) and the current block of outputs otherwise.    */
+#define ST_MAGIC "MTRS"
+#define ST_VERSION 1
+#define ST_SIZE (4+1+1+4+5*8+4*N)
 
-    /* Tempering */
-    y ^= (y >> 11);
-    y ^= (y << 7) & 0x9d2c5680U;
-    y ^= (y << 15) & 0xefc60000U;
-    y ^= (y >> 18);
+/* Store the nb lower bytes of v */
+static unsigned char *st_put(unsigned char *p,unsigned long long v,int nb)
+{
+ int i;
 
-    return y;
+ for(i=0;i<nb;i++,v>>=8)
+  *(p++)=(unsigned char)v;
+ return p;
 }
 
-static int rnd_int32(XPRMcontext ctx,void *libctx)
+/* Read a value of nb bytes */
+static const unsigned char *st_get(const unsigned char *p,
+                unsigned long long *v,int nb)
 {
- XPRM_PUSH_INT(ctx,(signed)genrand_int32(libctx));
- return RT_OK;
+ int i;
+
+ *v=0;
+ for(i=nb-1;i>=0;i--)
+  *v=(*v<<8)|p[i];
+ return p+nb;
 }
 
-static int rnd_int32b(XPRMcontext ctx,void *libctx)
+/*******************************************/
+/* Save the generator state to a file      */
+/* (any I/O driver can be used, e.g. mem:) */
+/*******************************************/
+static int rnd_getstate(XPRMcontext ctx,void *libctx)
 {
- int lo,up;
+ s_rndctx *rndctx;
+ unsigned char buf[ST_SIZE],*p;
+ const unsigned int *w;
+ const char *fname;
+ XPRMfile f;
+ int i,rts;
 
- lo=XPRM_POP_INT(ctx);
- up=XPRM_TOP_ST(ctx)->integer;
- if(lo!=up)
+ rndctx=libctx;
+ fname=XPRM_POP_STRING(ctx);
+ memcpy(buf,ST_MAGIC,4);
+ p=buf+4;
+ *(p++)=ST_VERSION;
+ *(p++)=(unsigned char)rndctx->engine;
+ p=st_put(p,(unsigned int)rndctx->mti,4);
+ p=st_put(p,rndctx->seed,8);
+ for(i=0;i<4;i++)
+  p=st_put(p,rndctx->es[i],8);
+ w=(rndctx->engine==ENG_MT19937)?rndctx->mt:rndctx->out;
+ for(i=0;i<N;i++)
+  p=st_put(p,w[i],4);
+
+ rts=RT_OK;
+ if((fname==NULL)||
+    ((f=mm->fopen(ctx,XPRM_F_WRITE|XPRM_F_BINARY,fname))==NULL))
+  rts=RT_IOERR;
+ else
  {
-  if(lo>up)
-  {
-   up=lo;
-   lo=XPRM_TOP_ST(ctx)->integer;
-  }
-  XPRM_TOP_ST(ctx)->integer=lo+(signed)(genrand_int32(libctx)%(up-lo+1));
+  if(mm->fwrite_(buf,1,ST_SIZE,f)!=ST_SIZE)
+   rts=RT_IOERR;
+  if(mm->fclose(f)!=0)
+   rts=RT_IOERR;
  }
- return RT_OK;
+ if(rts!=RT_OK)
+  mm->dispmsg(ctx,"RANDOM: cannot save generator state to `%s'.\n",
+                (fname!=NULL)?fname:"");
+ return rts;
 }
 
-/* generates a random number on [0,0x7fffffff]-interval */
-static int rnd_int31(XPRMcontext ctx,void *libctx)
+/*****************************************************/
+/* Restore a state saved by getmtrandstate: the      */
+/* engine of the saved generator becomes the current */
+/* engine                                            */
+/*****************************************************/
+static int rnd_setstate(XPRMcontext ctx,void *libctx)
 {
- XPRM_PUSH_INT(ctx,(int)(genrand_int32(libctx)>>1));
- return RT_OK;
-}
+ s_rndctx *rndctx;
+ unsigned char buf[ST_SIZE];
+ const unsigned char *p;
+ unsigned long long v;
+ unsigned int *w,y;
+ const char *fname;
+ XPRMfile f;
+ int i,engine,mti;
 
-/* generates a random number on [0,1]-real-interval */
-static int rnd_real1(XPRMcontext ctx,void *libctx)
-{
- XPRM_PUSH_REAL(ctx,genrand_int32(libctx)*(1.0/4294967295.0)); 
-    /* divided by 2^32-1 */ 
- return RT_OK;
-}
+ rndctx=libctx;
+ fname=XPRM_POP_STRING(ctx);
+ if((fname==NULL)||
+    ((f=mm->fopen(ctx,XPRM_F_READ|XPRM_F_BINARY,fname))==NULL))
+ {
+  mm->dispmsg(ctx,"RANDOM: cannot read generator state from `%s'.\n",
+                (fname!=NULL)?fname:"");
+  return RT_IOERR;
+ }
+ i=(mm->fread_(buf,1,ST_SIZE,f)==ST_SIZE);
+ mm->fclose(f);
+ p=buf+6;
+ p=st_get(p,&v,4);
+ engine=buf[5];
+ mti=(int)(unsigned int)v;
+ if(!i||memcmp(buf,ST_MAGIC,4)||(buf[4]!=ST_VERSION)||
+    (engine>=(int)ENG_NB)||(mti<0)||
+    (mti>((engine==ENG_MT19937)?N+1:N)))
+ {
+  mm->dispmsg(ctx,"RANDOM: invalid generator state in `%s'.\n",fname);
+  return RT_IOERR;
+ }
 
-/* generates a random number on [0,1)-real-interval */
-static int rnd_real2(XPRMcontext ctx,void *libctx)
-{
- XPRM_PUSH_REAL(ctx,genrand_int32(libctx)*(1.0/4294967296.0)); 
-    /* divided by 2^32 */
+ rndctx->engine=engine;
+ rndctx->mti=mti;
+ p=st_get(p,&(rndctx->seed),8);
+ for(i=0;i<4;i++)
+  p=st_get(p,rndctx->es+i,8);
+ w=(engine==ENG_MT19937)?rndctx->mt:rndctx->out;
+ for(i=0;i<N;i++)
+ {
+  p=st_get(p,&v,4);
+  w[i]=(unsigned int)v;
+ }
+ if(engine==ENG_MT19937)
+  for(i=0;i<N;i++)
+  {
+   y=rndctx->mt[i];
+   y^=(y>>11);                  /* Tempering (see mt_refill_c) */
+   y^=(y<<7)&0x9d2c5680U;
+   y^=(y<<15)&0xefc60000U;
+   y^=(y>>18);
+   rndctx->out[i]=y;
+  }
  return RT_OK;
 }
 
-/* generates a random number on (0,1)-real-interval */
-static int rnd_real3(XPRMcontext ctx,void *libctx)
-{
- XPRM_PUSH_REAL(ctx,(((double)genrand_int32(libctx))+0.5)*(1.0/4294967296.0)); 
-    /* divided by 2^32 */
- return RT_OK;
-}
+/**** Jump ahead ****/
+/* Jumping J steps ahead amounts to applying g(T) to the state where T */
+/* is the transition and g(x)=x^J mod phi(x), phi being the            */
+/* characteristic polynomial of the recurrence (degree 19937). Over    */
+/* GF(2) polynomials are stored as bit vectors in 64bit words.         */
 
-/* generates a random number on [0,1) with 53-bit resolution*/
-static double genrand_res53(s_rndctx *rndctx) 
-{ 
-    unsigned int a=genrand_int32(rndctx)>>5, b=genrand_int32(rndctx)>>6; 
-    return(a*67108864.0+b)*(1.0/9007199254740992.0); 
-} 
+/* Exponents of the terms of degree <JP_MEXP of phi (obtained from the */
+/* output sequence with the Berlekamp-Massey algorithm)                */
+static const unsigned short jp_phiterms[]={
+ 0,1189,1416,1585,1643,1870,2493,2773,3000,3227,3454,3681,3908,4135,
+ 4362,4753,5661,6337,6569,7129,7477,7525,7583,7752,7979,8206,9505,9901,
+ 9969,10128,10693,10761,10920,11089,11147,11157,11215,11321,11374,11384,
+ 11485,11611,11712,11717,11838,11881,11944,11997,12277,12335,12393,
+ 12504,12509,12620,12673,12731,12736,12789,12905,12958,12963,13137,
+ 13185,13190,13243,13301,13412,13528,13533,13639,13697,13760,13813,
+ 13866,14093,14151,14209,14320,14325,14436,14547,14552,14605,14721,
+ 14774,14779,14953,15001,15006,15059,15117,15228,15344,15349,15455,
+ 15513,15576,15629,15682,15909,15967,16025,16136,16141,16252,16363,
+ 16368,16421,16537,16590,16595,16817,16822,16875,16933,17044,17160,
+ 17271,17329,17445,17498,17725,17783,17841,17952,18068,18179,18237,
+ 18406,18633,18691,18860,19087,19314};
 
-static int rnd_real(XPRMcontext ctx,void *libctx)
+#define JP_NBTERMS (sizeof(jp_phiterms)/sizeof(jp_phiterms[0]))
+
+/* Add 'c' to polynomial 'p' from bit position 'pos' */
+static void jp_addword(unsigned long long *p,int pos,unsigned long long c)
 {
- XPRM_PUSH_REAL(ctx,genrand_res53(libctx)); 
- return RT_OK;
+ int s;
+
+ s=pos&63;
+ p[pos>>6]^=c<<s;
+ if(s>0) p[(pos>>6)+1]^=c>>(64-s);
 }
 
-static int rnd_realb(XPRMcontext ctx,void *libctx)
+/* Reduce polynomial 'p' (2*JP_NW words) modulo phi: as the terms of */
+/* phi below x^JP_MEXP are of degree at most JP_MEXP-623, reduction  */
+/* can be performed by blocks of 64 bits                             */
+static void jp_reduce(unsigned long long *p)
 {
- double lo,up;
+ unsigned long long c;
+ int w,t;
 
- lo=XPRM_POP_REAL(ctx);
- up=XPRM_TOP_ST(ctx)->real;
- if(lo!=up)
- {
-  if(lo>up)
+ for(w=2*JP_NW-1;w>=JP_NW;w--)
+  if((c=p[w])!=0)
   {
-   up=lo;
-   lo=XPRM_TOP_ST(ctx)->real;
+   p[w]=0;
+   for(t=0;t<JP_NBTERMS;t++)
+    jp_addword(p,w*64-JP_MEXP+jp_phiterms[t],c);
   }
-  XPRM_TOP_ST(ctx)->real=lo+(genrand_res53(libctx)*(up-lo));
+ c=p[JP_NW-1]>>(JP_MEXP&63);
+ if(c!=0)
+ {
+  p[JP_NW-1]&=(1ULL<<(JP_MEXP&63))-1;
+  for(t=0;t<JP_NBTERMS;t++)
+   jp_addword(p,jp_phiterms[t],c);
  }
- return RT_OK;
 }
 
-/* These real versions are due to Isaku Wada, 2002/01/09 added */
+/* Interleave the bits of 'x' with zeroes (squaring over GF(2)) */
+static unsigned long long jp_spread(unsigned int x)
+{
+ unsigned long long v;
 
-#define RANDOM genrand_res53(rndctx)
-/* ========================================================
- * Returns 1 with probability p or 0 with probability 1 - p. 
- * NOTE: use 0.0 < p < 1.0                                   
- * ========================================================
- */ 
-static int bernoulli(s_rndctx *rndctx,double p)
-{ return ((RANDOM < (1.0 - p)) ? 0 : 1); }
+ v=x;
+ v=(v|(v<<16))&0x0000FFFF0000FFFFULL;
+ v=(v|(v<<8))&0x00FF00FF00FF00FFULL;
+ v=(v|(v<<4))&0x0F0F0F0F0F0F0F0FULL;
+ v=(v|(v<<2))&0x3333333333333333ULL;
+ v=(v|(v<<1))&0x5555555555555555ULL;
+ return v;
+}
 
-static int rnd_bernoulli(XPRMcontext ctx,void *libctx)
+/* p=p^2 mod phi */
+static void jp_sqr(unsigned long long *p)
 {
- double p;
+ int w;
 
- p=XPRM_TOP_ST(ctx)->real;
- if((p<=0)||(p>=1))
-  return rnd_math_error(ctx,"bernoulli");
- else
+ for(w=JP_NW-1;w>=0;w--)
  {
-  XPRM_TOP_ST(ctx)->integer=bernoulli(libctx,p);
-  return XPRM_RT_OK;
+  p[2*w+1]=jp_spread((unsigned int)(p[w]>>32));
+  p[2*w]=jp_spread((unsigned int)p[w]);
  }
+ jp_reduce(p);
 }
 
-/* ================================================================ 
- * Returns a binomial distributed integer between 0 and n inclusive. 
- * NOTE: use n > 0 and 0.0 < p < 1.0
- * ================================================================
- */
-static int rnd_binomial(XPRMcontext ctx,void *libctx)
+/* p=p*x mod phi */
+static void jp_mulx(unsigned long long *p)
 {
- int n,x;
- double p;
+ int w;
 
- n=XPRM_POP_INT(ctx);
- p=XPRM_TOP_ST(ctx)->real;
- if((n<=0)||(p<=0)||(p>=1))
-  return rnd_math_error(ctx,"binomial");
- else
+ for(w=JP_NW;w>0;w--)
+  p[w]=(p[w]<<1)|(p[w-1]>>63);
+ p[0]<<=1;
+ jp_reduce(p);
+}
+
+/* Compute p=x^(k*2^e) mod phi (p: 2*JP_NW words) */
+static void jp_jumppoly(unsigned long long *p,unsigned int k,int e)
+{
+ int i;
+
+ memset(p,0,2*JP_NW*sizeof(unsigned long long));
+ p[0]=1;
+ for(i=31;i>=0;i--)
  {
-  x=0;
-  for(;n>0;n--)
-   x+=bernoulli(libctx,p);
-  XPRM_TOP_ST(ctx)->integer=x;
-  return XPRM_RT_OK;
+  jp_sqr(p);
+  if((k>>i)&1)
+   jp_mulx(p);
  }
+ for(i=0;i<e;i++)
+  jp_sqr(p);
 }
 
-/* ====================================================
- * Returns a geometric distributed non-negative integer.
- * NOTE: use 0.0 < p < 1.0
- * ====================================================
- */
-static int geometric(s_rndctx *rndctx,double p)
-{ return ((int) (log(1.0 - RANDOM) / log(p))); }
+/* One step of the recurrence on a state stored as a ring from 'pos' */
+static int jp_next(unsigned int *st,int pos)
+{
+ unsigned int y;
 
-static int rnd_geometric(XPRMcontext ctx,void *libctx)
+ y=(st[pos]&UPPER_MASK)|(st[(pos+1)%N]&LOWER_MASK);
+ st[pos]=st[(pos+M)%N]^(y>>1)^((y&1)?MATRIX_A:0U);
+ return (pos+1)%N;
+}
+
+/* Apply the jump polynomial 'p' to the state (Horner scheme) */
+/* The state must be at a block boundary (mti==N)             */
+static void mt_jump(s_rndctx *rndctx,const unsigned long long *p)
 {
- double p;
+ unsigned int st[N];
+ int deg,pos,i,j;
 
- p=XPRM_TOP_ST(ctx)->real;
- if((p<=0)||(p>=1))
-  return rnd_math_error(ctx,"geometric");
- else
+ for(deg=JP_MEXP-1;(deg>0)&&!((p[deg>>6]>>(deg&63))&1);deg--);
+ memset(st,0,sizeof(st));
+ pos=0;
+ for(i=deg;i>=0;i--)
  {
-  XPRM_TOP_ST(ctx)->integer=geometric(libctx,p);
-  return XPRM_RT_OK;
+  if((p[i>>6]>>(i&63))&1)
+  {
+   for(j=0;j<N-pos;j++) st[pos+j]^=rndctx->mt[j];
+   for(;j<N;j++) st[pos+j-N]^=rndctx->mt[j];
+  }
+  if(i>0) pos=jp_next(st,pos);
  }
+ for(j=0;j<N;j++)
+  rndctx->mt[j]=st[(pos+j)%N];
+ rndctx->mti=N;
 }
 
-/* ================================================= 
- * Returns a Pascal distributed non-negative integer. 
- * NOTE: use n > 0 and 0.0 < p < 1.0
- * =================================================
- */
-static int rnd_pascal(XPRMcontext ctx,void *libctx)
+/* generates a random number on [0,0xffffffff]-interval */
+static unsigned int genrand_int32(s_rndctx *rndctx)
 {
- int n,x;
- double p;
+    if (rndctx->mti >= N) { /* generate N words at one time */
+        if (rndctx->engine != ENG_MT19937)
+            eng_refill(rndctx);
+        else {
+            if (rndctx->mti == N+1)   /* if init_genrand() has not been called, */
+                init_genrand(rndctx,5489U); /* a default initial seed is used */
+            mt_refill(rndctx);
+        }
+        rndctx->mti = 0;
+    }
+  
+    return rndctx->out[rndctx->mti++];
+}
+
+/* Block refill: twist of the whole state followed by the tempering of */
+/* the N new words into 'out'. All versions produce the same stream.   */
+static void mt_refill_c(s_rndctx *rndctx)
+{
+    unsigned int y;
+    static unsigned int mag01[2]={0x0U, MATRIX_A};
+    /* mag01[x] = x * MATRIX_A  for x=0,1 */
+    int kk;
+
+    for (kk=0;kk<N-M;kk++) {
+        y = (rndctx->mt[kk]&UPPER_MASK)|(rndctx->mt[kk+1]&LOWER_MASK);
+        rndctx->mt[kk] = rndctx->mt[kk+M] ^ (y >> 1) ^ mag01[y & 0x1U];
+    }
+    for (;kk<N-1;kk++) {
+        y = (rndctx->mt[kk]&UPPER_MASK)|(rndctx->mt[kk+1]&LOWER_MASK);
+        rndctx->mt[kk] = rndctx->mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & 0x1U];
+    }
+    y = (rndctx->mt[N-1]&UPPER_MASK)|(rndctx->mt[0]&LOWER_MASK);
+    rndctx->mt[N-1] = rndctx->mt[M-1] ^ (y >> 1) ^ mag01[y & 0x1U];
+
+    for (kk=0;kk<N;kk++) {
+        y = rndctx->mt[kk];
+
+        /* Tempering */
+        y ^= (y >> 11);
+        y ^= (y << 7) & 0x9d2c5680U;
+        y ^= (y << 15) & 0xefc60000U;
+        y ^= (y >> 18);
+        rndctx->out[kk] = y;
+    }
+}
+
+/* The new value of word kk depends on words kk+1 and kk+M (not updated  */
+/* yet) or kk+M-N (already updated and at least N-M>8 words behind):     */
+/* consecutive words can therefore be computed in parallel.              */
+#define MT_TWIST1(kk,far) \
+    { unsigned int y=(rndctx->mt[kk]&UPPER_MASK)|(rndctx->mt[(kk)+1]&LOWER_MASK);\
+      rndctx->mt[kk]=rndctx->mt[far]^(y>>1)^((0U-(y&0x1U))&MATRIX_A); }
+
+#ifdef RND_SSE2
+#define MT_TWIST4(kk,far) \
+    { __m128i y=_mm_or_si128( \
+          _mm_and_si128(_mm_loadu_si128((__m128i*)(rndctx->mt+(kk))),upper),\
+          _mm_and_si128(_mm_loadu_si128((__m128i*)(rndctx->mt+(kk)+1)),lower));\
+      __m128i mag=_mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(y,one),one),matrixa);\
+      _mm_storeu_si128((__m128i*)(rndctx->mt+(kk)),_mm_xor_si128( \
+          _mm_xor_si128(_mm_loadu_si128((__m128i*)(rndctx->mt+(far))), \
+                        _mm_srli_epi32(y,1)),mag)); }
+
+static void mt_refill_sse2(s_rndctx *rndctx)
+{
+    const __m128i upper=_mm_set1_epi32((int)UPPER_MASK);
+    const __m128i lower=_mm_set1_epi32((int)LOWER_MASK);
+    const __m128i one=_mm_set1_epi32(1);
+    const __m128i matrixa=_mm_set1_epi32((int)MATRIX_A);
+    const __m128i mask1=_mm_set1_epi32((int)0x9d2c5680U);
+    const __m128i mask2=_mm_set1_epi32((int)0xefc60000U);
+    __m128i y;
+    int kk;
+
+    for (kk=0;kk+4<=N-M;kk+=4)
+        MT_TWIST4(kk,kk+M)
+    for (;kk<N-M;kk++)
+        MT_TWIST1(kk,kk+M)
+    for (;kk<N-1;kk+=4)    /* N-1-(N-M) is a multiple of 4 */
+        MT_TWIST4(kk,kk+(M-N))
+    { unsigned int y=(rndctx->mt[N-1]&UPPER_MASK)|(rndctx->mt[0]&LOWER_MASK);
+      rndctx->mt[N-1]=rndctx->mt[M-1]^(y>>1)^((0U-(y&0x1U))&MATRIX_A); }
+
+    for (kk=0;kk<N;kk+=4) {
+        y = _mm_loadu_si128((__m128i*)(rndctx->mt+kk));
+        y = _mm_xor_si128(y,_mm_srli_epi32(y,11));
+        y = _mm_xor_si128(y,_mm_and_si128(_mm_slli_epi32(y,7),mask1));
+        y = _mm_xor_si128(y,_mm_and_si128(_mm_slli_epi32(y,15),mask2));
+        y = _mm_xor_si128(y,_mm_srli_epi32(y,18));
+        _mm_storeu_si128((__m128i*)(rndctx->out+kk),y);
+    }
+}
+#endif
+
+#ifdef RND_AVX2
+#define MT_TWIST8(kk,far) \
+    { __m256i y=_mm256_or_si256( \
+          _mm256_and_si256(_mm256_loadu_si256((__m256i*)(rndctx->mt+(kk))),upper),\
+          _mm256_and_si256(_mm256_loadu_si256((__m256i*)(rndctx->mt+(kk)+1)),lower));\
+      __m256i mag=_mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(y,one),one),matrixa);\
+      _mm256_storeu_si256((__m256i*)(rndctx->mt+(kk)),_mm256_xor_si256( \
+          _mm256_xor_si256(_mm256_loadu_si256((__m256i*)(rndctx->mt+(far))), \
+                           _mm256_srli_epi32(y,1)),mag)); }
+
+__attribute__((target("avx2")))
+static void mt_refill_avx2(s_rndctx *rndctx)
+{
+    const __m256i upper=_mm256_set1_epi32((int)UPPER_MASK);
+    const __m256i lower=_mm256_set1_epi32((int)LOWER_MASK);
+    const __m256i one=_mm256_set1_epi32(1);
+    const __m256i matrixa=_mm256_set1_epi32((int)MATRIX_A);
+    const __m256i mask1=_mm256_set1_epi32((int)0x9d2c5680U);
+    const __m256i mask2=_mm256_set1_epi32((int)0xefc60000U);
+    __m256i y;
+    int kk;
+
+    for (kk=0;kk+8<=N-M;kk+=8)
+        MT_TWIST8(kk,kk+M)
+    for (;kk<N-M;kk++)
+        MT_TWIST1(kk,kk+M)
+    for (;kk+8<=N-1;kk+=8)
+        MT_TWIST8(kk,kk+(M-N))
+    for (;kk<N-1;kk++)
+        MT_TWIST1(kk,kk+(M-N))
+    { unsigned int y=(rndctx->mt[N-1]&UPPER_MASK)|(rndctx->mt[0]&LOWER_MASK);
+      rndctx->mt[N-1]=rndctx->mt[M-1]^(y>>1)^((0U-(y&0x1U))&MATRIX_A); }
+
+    for (kk=0;kk<N;kk+=8) {
+        y = _mm256_loadu_si256((__m256i*)(rndctx->mt+kk));
+        y = _mm256_xor_si256(y,_mm256_srli_epi32(y,11));
+        y = _mm256_xor_si256(y,_mm256_and_si256(_mm256_slli_epi32(y,7),mask1));
+        y = _mm256_xor_si256(y,_mm256_and_si256(_mm256_slli_epi32(y,15),mask2));
+        y = _mm256_xor_si256(y,_mm256_srli_epi32(y,18));
+        _mm256_storeu_si256((__m256i*)(rndctx->out+kk),y);
+    }
+}
+#endif
+
+/**** Small-state engines ****/
+/* These engines also generate blocks of N words into 'out' such that  */
+/* all distributions go through genrand_int32 whatever the engine.     */
+/* 64bit outputs are stored as 2 words (high order first) and          */
+/* 'es' holds the engine state:                                        */
+/*  xoshiro256**: s[0..3]                                              */
+/*  PCG64: state (es[0]: low, es[1]: high), increment (es[2],es[3])    */
+/*  Philox4x32: counter (es[0]: low, es[1]: high = stream), key es[2]  */
+
+#define ROTL64(x,k) (((x)<<(k))|((x)>>(64-(k))))
+
+/* SplitMix64: used to derive engine states from a seed */
+static unsigned long long splitmix64(unsigned long long *x)
+{
+ unsigned long long z;
+
+ z=(*x+=0x9e3779b97f4a7c15ULL);
+ z=(z^(z>>30))*0xbf58476d1ce4e5b9ULL;
+ z=(z^(z>>27))*0x94d049bb133111ebULL;
+ return z^(z>>31);
+}
+
+/* Jump polynomials of xoshiro256** for 2^(128+i) steps, i=0..30 */
+static const unsigned long long xo_jumps[31][4]={
+         {0x180ec6d33cfd0abaULL,0xd5a61266f0c9392cULL,0xa9582618e03fc9aaULL,0x39abdc4529b1661cULL},
+         {0x8cfe9bd9ab71d992ULL,0xccfc8ca2814de79eULL,0xa5a28cccb37dba5bULL,0xa23e49ee6f1a7a8dULL},
+         {0x1b2a94a672a48c05ULL,0x5e38f4fbb6fcda72ULL,0xca8a45310219dc67ULL,0xd4e9921bccb8090bULL},
+         {0xf30974a2b1dbbb71ULL,0x34cd4cc8228d74acULL,0xfa0587a90f717438ULL,0xee658f69deb5df26ULL},
+         {0xb42bd4670583b289ULL,0xd2c0d8e0c8a2fb9bULL,0x2573e3218d8bb7daULL,0xd7aaaf48aa459c58ULL},
+         {0xf6a5ab84efb67883ULL,0xcc7efdcfed1ac303ULL,0xd82be75b83dbc2d0ULL,0x8fd437c01abeab24ULL},
+         {0xc85ee5171484f5a4ULL,0xedc8b8d02a22310bULL,0xb0b87a330b854c8aULL,0x7d16742eceb4d5abULL},
+         {0x4298ba0e862a6007ULL,0x4157dc48443e3565ULL,0x13c97c0891cab48aULL,0x6533981804b420eaULL},
+         {0xee5f5a6f02dfe47cULL,0xedc28c89cb341660ULL,0x613b2ed9f0acc107ULL,0xa1ee335d14807ae0ULL},
+         {0x5ec3050c6b43565aULL,0x4b26f71c1fb1b47bULL,0x0531513e8e0ac706ULL,0x799d469b2145a8a3ULL},
+         {0x34f0a6799020283eULL,0x7123f2290a1f413bULL,0xb6acd7be4906b73dULL,0x6007bb31ec5a2964ULL},
+         {0xaa0711c54877febdULL,0x54fe6df4cff0db73ULL,0x7e42d6f544840499ULL,0xec907801890a47abULL},
+         {0x03833e601d82a673ULL,0x3ec263f5c999196eULL,0xd8c4367e574ab160ULL,0x964e9d188c16508eULL},
+         {0xd64f3f2aaf8f2171ULL,0xf524fd4408357a5cULL,0x15ac212f3b861b5aULL,0x24d9ba21277dd8d8ULL},
+         {0xfe9b778d7d1ca2deULL,0xbbe0e2c0c44b2e1cULL,0x17a7af3e97d8c402ULL,0xf89354cfe1e6b5fbULL},
+         {0x695cf225704e767dULL,0xf4873d277cd1ab72ULL,0xaad8c318bc459cceULL,0xb89526857566cd94ULL},
+         {0x3dcd32f39276a95fULL,0xc51212c8b1aa2787ULL,0x962c90a866ea6719ULL,0xb81875d0f4f6f253ULL},
+         {0xb43cf8e4eaf8e068ULL,0x1c554e97b2277f47ULL,0xa5a140826c351d07ULL,0x11495a1b200d4eb8ULL},
+         {0x417b73b324735d32ULL,0xff957b6f55288048ULL,0x05af69bf1fb82891ULL,0x3e53bfa0db28e110ULL},
+         {0xb6c7a6004612889cULL,0xfdb3f4ea18f0a56bULL,0xd3da65e82bdd39e2ULL,0x48f6214560239b46ULL},
+         {0xf1267ba0ec3c645eULL,0xd9dc0929a54fea75ULL,0xec60b640d685171dULL,0xde364ef64a484f59ULL},
+         {0x2761cbab38e0f580ULL,0xd7f1c5ade3de404aULL,0xcb6286958a9af01aULL,0x2b29c7d3ef18d3b3ULL},
+         {0x5a5ce93f67a3cdd6ULL,0x547db3576511edc2ULL,0x99455c744595c01fULL,0x6a3b6a431109e3d1ULL},
+         {0xafd80c1c832a739eULL,0x0d9d73da9f40f374ULL,0xed1d0a619aa60748ULL,0x00d2333b0c03f620ULL},
+         {0x11428ceb13f2cc2cULL,0xef46e42368baead3ULL,0x2a47bd3fc39081daULL,0x3f03458e0273439bULL},
+         {0x47558e815c898e8bULL,0x9f8160e9d0124398ULL,0x0fdcfd4ab0f5afeeULL,0xade2626c292a2a9fULL},
+         {0xe848ff06d72a9252ULL,0xf8be2d3d6ce206b0ULL,0xd84fc5f798c1a55eULL,0xc35abe5cebab1ba4ULL},
+         {0xb0dd0edb19af078cULL,0xee1d857a675ca074ULL,0x60ef7116e6f3c1e0ULL,0x7c25b2c3282fb730ULL},
+         {0xb51a19064886308aULL,0x6b590805d407e77eULL,0x57059d3707ee283aULL,0x6298f48fa13cc12fULL},
+         {0x4f1102acb29c3230ULL,0xcf69cee6182fa164ULL,0x1780be415c86b5d5ULL,0xab5d0760d1fe77dcULL},
+         {0xc639b7c24b26ef11ULL,0xa57d650a8007d505ULL,0xd81275131f4f91f8ULL,0x10000e5f7bf7a58bULL}
+	};
+
+/* One step of xoshiro256** */
+static unsigned long long xo_next(unsigned long long *s)
+{
+ unsigned long long r,t;
+
+ r=ROTL64(s[1]*5,7)*9;
+ t=s[1]<<17;
+ s[2]^=s[0];
+ s[3]^=s[1];
+ s[1]^=s[2];
+ s[0]^=s[3];
+ s[2]^=t;
+ s[3]=ROTL64(s[3],45);
+ return r;
+}
+
+/* Apply a jump polynomial to the xoshiro256** state */
+static void xo_jump(unsigned long long *s,const unsigned long long *jmp)
+{
+ unsigned long long t[4];
+ int i,b;
+
+ t[0]=t[1]=t[2]=t[3]=0;
+ for(i=0;i<4;i++)
+  for(b=0;b<64;b++)
+  {
+   if(jmp[i]&(1ULL<<b))
+   {
+    t[0]^=s[0];
+    t[1]^=s[1];
+    t[2]^=s[2];
+    t[3]^=s[3];
+   }
+   xo_next(s);
+  }
+ memcpy(s,t,sizeof(t));
+}
+
+/* High order 64 bits of a 64x64 product */
+static unsigned long long mulhi64(unsigned long long a,unsigned long long b)
+{
+#ifdef __SIZEOF_INT128__
+ return (unsigned long long)(((unsigned __int128)a*b)>>64);
+#else
+ unsigned long long a0,a1,b0,b1,p01,p10,mid;
+
+ a0=a&0xffffffffU; a1=a>>32;
+ b0=b&0xffffffffU; b1=b>>32;
+ p01=a0*b1;
+ p10=a1*b0;
+ mid=((a0*b0)>>32)+(p01&0xffffffffU)+(p10&0xffffffffU);
+ return a1*b1+(p01>>32)+(p10>>32)+(mid>>32);
+#endif
+}
+
+#define PCG_MULT_HI 2549297995355413924ULL
+#define PCG_MULT_LO 4865540595714422341ULL
+
+/* One step of the PCG64 LCG (128bit state) */
+#define PCG_STEP(lo,hi,ilo,ihi) \
+    { unsigned long long l=(lo)*PCG_MULT_LO; \
+      (hi)=mulhi64(lo,PCG_MULT_LO)+(hi)*PCG_MULT_LO+(lo)*PCG_MULT_HI+(ihi); \
+      (lo)=l+(ilo); \
+      if((lo)<l) (hi)++; }
+
+/* PCG64 initialisation with a 128bit state and a stream number */
+static void pcg_init(s_rndctx *rndctx,unsigned long long sthi,
+                unsigned long long stlo,unsigned long long seq)
+{
+ unsigned long long lo,hi,ilo,ihi;
+
+ ilo=(seq<<1)|1;
+ ihi=seq>>63;
+ lo=hi=0;
+ PCG_STEP(lo,hi,ilo,ihi);
+ lo+=stlo;
+ hi+=sthi+((lo<stlo)?1:0);
+ PCG_STEP(lo,hi,ilo,ihi);
+ rndctx->es[0]=lo; rndctx->es[1]=hi;
+ rndctx->es[2]=ilo; rndctx->es[3]=ihi;
+}
+
+/* Philox4x32-10 (Salmon et al., SC11): encrypt counter 'ctr' with 'key' */
+#define PHX_M0 0xD2511F53U
+#define PHX_M1 0xCD9E8D57U
+#define PHX_W0 0x9E3779B9U
+#define PHX_W1 0xBB67AE85U
+
+static void philox4x32(const unsigned int *ctr,const unsigned int *key,
+                unsigned int *out)
+{
+ unsigned long long p0,p1;
+ unsigned int c0,c1,c2,c3,k0,k1;
+ int r;
+
+ c0=ctr[0]; c1=ctr[1]; c2=ctr[2]; c3=ctr[3];
+ k0=key[0]; k1=key[1];
+ for(r=0;r<10;r++)
+ {
+  p0=(unsigned long long)PHX_M0*c0;
+  p1=(unsigned long long)PHX_M1*c2;
+  c0=(unsigned int)(p1>>32)^c1^k0;
+  c1=(unsigned int)p1;
+  c2=(unsigned int)(p0>>32)^c3^k1;
+  c3=(unsigned int)p0;
+  k0+=PHX_W0;
+  k1+=PHX_W1;
+ }
+ out[0]=c0; out[1]=c1; out[2]=c2; out[3]=c3;
+}
+
+/* Generate the next block of N words */
+static void eng_refill(s_rndctx *rndctx)
+{
+ unsigned long long s[4],r,lo,hi,ilo,ihi;
+ unsigned int ctr[4],key[2];
+ int i;
+ unsigned int rot;
+
+ switch(rndctx->engine)
+ {
+  case ENG_XOSHIRO:
+    memcpy(s,rndctx->es,sizeof(s));
+    for(i=0;i<N;i+=2)
+    {
+     r=xo_next(s);
+     rndctx->out[i]=(unsigned int)(r>>32);
+     rndctx->out[i+1]=(unsigned int)r;
+    }
+    memcpy(rndctx->es,s,sizeof(s));
+    break;
+  case ENG_PCG64:
+    lo=rndctx->es[0]; hi=rndctx->es[1];
+    ilo=rndctx->es[2]; ihi=rndctx->es[3];
+    for(i=0;i<N;i+=2)
+    {
+     PCG_STEP(lo,hi,ilo,ihi);
+     r=hi^lo;                   /* XSL-RR output function */
+     rot=(unsigned int)(hi>>58);
+     r=(r>>rot)|(r<<((64-rot)&63));
+     rndctx->out[i]=(unsigned int)(r>>32);
+     rndctx->out[i+1]=(unsigned int)r;
+    }
+    rndctx->es[0]=lo; rndctx->es[1]=hi;
+    break;
+  case ENG_PHILOX:
+    key[0]=(unsigned int)rndctx->es[2];
+    key[1]=(unsigned int)(rndctx->es[2]>>32);
+    ctr[2]=(unsigned int)rndctx->es[1];
+    ctr[3]=(unsigned int)(rndctx->es[1]>>32);
+    for(i=0;i<N;i+=4)
+    {
+     ctr[0]=(unsigned int)rndctx->es[0];
+     ctr[1]=(unsigned int)(rndctx->es[0]>>32);
+     philox4x32(ctr,key,rndctx->out+i);
+     rndctx->es[0]++;
+    }
+    break;
+ }
+}
+
+/* Move the current engine to stream k of its seed */
+static void eng_stream(s_rndctx *rndctx,unsigned int k)
+{
+ unsigned long long x,lo,hi;
+ int i;
+
+ switch(rndctx->engine)
+ {
+  case ENG_XOSHIRO:             /* k*2^128 steps ahead */
+    for(i=0;i<31;i++)
+     if((k>>i)&1)
+      xo_jump(rndctx->es,xo_jumps[i]);
+    break;
+  case ENG_PCG64:               /* Stream = LCG increment */
+    x=rndctx->seed;
+    hi=splitmix64(&x);
+    lo=splitmix64(&x);
+    pcg_init(rndctx,hi,lo,k);
+    break;
+  case ENG_PHILOX:              /* Stream = high order part of counter */
+    rndctx->es[0]=0;
+    rndctx->es[1]=k;
+    break;
+ }
+ rndctx->mti=N;
+}
+
+static int rnd_int32(XPRMcontext ctx,void *libctx)
+{
+ XPRM_PUSH_INT(ctx,(signed)genrand_int32(libctx));
+ return RT_OK;
+}
+
+static int rnd_int32b(XPRMcontext ctx,void *libctx)
+{
+ unsigned int range;
+ int lo,up;
+
+ lo=XPRM_POP_INT(ctx);
+ up=XPRM_TOP_ST(ctx)->integer;
+ if(lo!=up)
+ {
+  if(lo>up)
+  {
+   up=lo;
+   lo=XPRM_TOP_ST(ctx)->integer;
+  }
+  range=(unsigned int)up-(unsigned int)lo+1;    /* 0: full 32bit range */
+  XPRM_TOP_ST(ctx)->integer=(int)((long long)lo+
+                 ((range==0)?genrand_int32(libctx):
+                             genrand_int32(libctx)%range));
+ }
+ return RT_OK;
+}
+
+/* generates a random number on [0,0x7fffffff]-interval */
+static int rnd_int31(XPRMcontext ctx,void *libctx)
+{
+ XPRM_PUSH_INT(ctx,(int)(genrand_int32(libctx)>>1));
+ return RT_OK;
+}
+
+/* generates a random number on [0,1]-real-interval */
+static int rnd_real1(XPRMcontext ctx,void *libctx)
+{
+ XPRM_PUSH_REAL(ctx,genrand_int32(libctx)*(1.0/4294967295.0)); 
+    /* divided by 2^32-1 */ 
+ return RT_OK;
+}
+
+/* generates a random number on [0,1)-real-interval */
+static int rnd_real2(XPRMcontext ctx,void *libctx)
+{
+ XPRM_PUSH_REAL(ctx,genrand_int32(libctx)*(1.0/4294967296.0)); 
+    /* divided by 2^32 */
+ return RT_OK;
+}
+
+/* generates a random number on (0,1)-real-interval */
+static int rnd_real3(XPRMcontext ctx,void *libctx)
+{
+ XPRM_PUSH_REAL(ctx,(((double)genrand_int32(libctx))+0.5)*(1.0/4294967296.0)); 
+    /* divided by 2^32 */
+ return RT_OK;
+}
+
+/* generates a random number on [0,1) with 53-bit resolution*/
+static double genrand_res53(s_rndctx *rndctx) 
+{ 
+    unsigned int a=genrand_int32(rndctx)>>5, b=genrand_int32(rndctx)>>6; 
+    return(a*67108864.0+b)*(1.0/9007199254740992.0); 
+} 
+
+static int rnd_real(XPRMcontext ctx,void *libctx)
+{
+ XPRM_PUSH_REAL(ctx,genrand_res53(libctx)); 
+ return RT_OK;
+}
+
+static int rnd_realb(XPRMcontext ctx,void *libctx)
+{
+ double lo,up;
+
+ lo=XPRM_POP_REAL(ctx);
+ up=XPRM_TOP_ST(ctx)->real;
+ if(lo!=up)
+ {
+  if(lo>up)
+  {
+   up=lo;
+   lo=XPRM_TOP_ST(ctx)->real;
+  }
+  XPRM_TOP_ST(ctx)->real=lo+(genrand_res53(libctx)*(up-lo));
+ }
+ return RT_OK;
+}
+
+/* These real versions are due to Isaku Wada, 2002/01/09 added */
+
+#define RANDOM genrand_res53(rndctx)
+/* ========================================================
+ * Returns 1 with probability p or 0 with probability 1 - p. 
+ * NOTE: use 0.0 < p < 1.0                                   
+ * ========================================================
+ */ 
+static int bernoulli(s_rndctx *rndctx,double p)
+{ return ((RANDOM < (1.0 - p)) ? 0 : 1); }
+
+static int rnd_bernoulli(XPRMcontext ctx,void *libctx)
+{
+ double p;
+
+ p=XPRM_TOP_ST(ctx)->real;
+ if((p<=0)||(p>=1))
+  return rnd_math_error(ctx,"bernoulli");
+ else
+ {
+  XPRM_TOP_ST(ctx)->integer=bernoulli(libctx,p);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ================================================================ 
+ * Returns a binomial distributed integer between 0 and n inclusive. 
+ * NOTE: use n > 0 and 0.0 < p < 1.0
+ *
+ * Small values of n are handled by summing Bernoulli variates, then
+ * sequential inversion is used while n*min(p,1-p) is below 30 and the
+ * BTPE algorithm of Kachitvichyanukul & Schmeiser (Comm. ACM, 1988,
+ * vol 31, pp 216-222) above: the cost per draw is then independent of n.
+ * ================================================================
+ */
+#define BINOMIAL_SMALLN 30      /* Below this value of n: sum of Bernoulli */
+#define BINOMIAL_BTPE   30      /* From this value of n*min(p,1-p): BTPE */
+
+static int binomial_inv(s_rndctx *rndctx,int n,double p);
+static int binomial_btpe(s_rndctx *rndctx,int n,double p);
+
+static int binomial(s_rndctx *rndctx,int n,double p)
+{
+ int x;
+ double r;
+
+ if(n<BINOMIAL_SMALLN)
+ {
+  x=0;
+  for(;n>0;n--)
+   x+=bernoulli(rndctx,p);
+  return x;
+ }
+ else
+ {
+  r=(p<=0.5)?p:1.0-p;
+  x=(n*r<BINOMIAL_BTPE)?binomial_inv(rndctx,n,r):binomial_btpe(rndctx,n,r);
+  return (p<=0.5)?x:n-x;
+ }
+}
+
+/* Inversion (expected cost O(n*p)) - here p<=0.5 */
+static int binomial_inv(s_rndctx *rndctx,int n,double p)
+{
+ double q,qn,np,bound,px,u;
+ int x;
+
+ q=1.0-p;
+ qn=exp(n*log(q));
+ np=n*p;
+ bound=np+10.0*sqrt(np*q+1);
+ if(bound>n) bound=n;
+
+ x=0;
+ px=qn;
+ u=RANDOM;
+ while(u>px)
+ {
+  x++;
+  if(x>bound)
+  {
+   x=0;
+   px=qn;
+   u=RANDOM;
+  }
+  else
+  {
+   u-=px;
+   px=((n-x+1)*p*px)/(x*q);
+  }
+ }
+ return x;
+}
+
+/* BTPE: triangle, parallelogram and exponential tails - here p<=0.5 */
+static int binomial_btpe(s_rndctx *rndctx,int n,double p)
+{
+ double r,q,fm,p1,xm,xl,xr,c,laml,lamr,p2,p3,p4;
+ double a,u,v,s,F,rho,t,A,nrq,x1,f1,z,w,x2,f2,z2,w2,x;
+ int m,y,k,i;
+
+ r=p;
+ q=1.0-r;
+ fm=n*r+r;
+ m=(int)floor(fm);
+ nrq=n*r*q;
+ p1=floor(2.195*sqrt(nrq)-4.6*q)+0.5;
+ xm=m+0.5;
+ xl=xm-p1;
+ xr=xm+p1;
+ c=0.134+20.5/(15.3+m);
+ a=(fm-xl)/(fm-xl*r);
+ laml=a*(1.0+a/2.0);
+ a=(xr-fm)/(xr*q);
+ lamr=a*(1.0+a/2.0);
+ p2=p1*(1.0+2.0*c);
+ p3=p2+c/laml;
+ p4=p3+c/lamr;
+
+ for(;;)
+ {
+  u=RANDOM*p4;
+  v=RANDOM;
+  if(u<=p1)                             /* Triangular region */
+   return (int)floor(xm-p1*v+u);
+  else
+  if(u<=p2)                             /* Parallelograms */
+  {
+   x=xl+(u-p1)/c;
+   v=v*c+1.0-fabs(m-x+0.5)/p1;
+   if(v>1.0) continue;
+   y=(int)floor(x);
+  }
+  else
+  if(u<=p3)                             /* Left exponential tail */
+  {
+   y=(int)floor(xl+log(v)/laml);
+   if((y<0)||(v==0.0)) continue;
+   v=v*(u-p2)*laml;
+  }
+  else                                  /* Right exponential tail */
+  {
+   y=(int)floor(xr-log(v)/lamr);
+   if((y>n)||(v==0.0)) continue;
+   v=v*(u-p3)*lamr;
+  }
+
+  k=abs(y-m);
+  if((k<=20)||(k>=nrq/2.0-1))           /* Explicit evaluation of f(y)/f(m) */
+  {
+   s=r/q;
+   a=s*(n+1);
+   F=1.0;
+   if(m<y)
+    for(i=m+1;i<=y;i++) F*=(a/i-s);
+   else
+   if(m>y)
+    for(i=y+1;i<=m;i++) F/=(a/i-s);
+   if(v<=F) return y;
+  }
+  else                                  /* Squeeze then Stirling bounds */
+  {
+   rho=(k/nrq)*((k*(k/3.0+0.625)+0.16666666666666666)/nrq+0.5);
+   t=-(double)k*k/(2*nrq);
+   A=log(v);
+   if(A<(t-rho)) return y;
+   if(A>(t+rho)) continue;
+   x1=y+1;
+   f1=m+1;
+   z=n+1-m;
+   w=n-y+1;
+   x2=x1*x1;
+   f2=f1*f1;
+   z2=z*z;
+   w2=w*w;
+   if(A<=(xm*log(f1/x1)+(n-m+0.5)*log(z/w)+(y-m)*log(w*r/(x1*q))+
+          (13680.-(462.-(132.-(99.-140./f2)/f2)/f2)/f2)/f1/166320.+
+          (13680.-(462.-(132.-(99.-140./z2)/z2)/z2)/z2)/z/166320.+
+          (13680.-(462.-(132.-(99.-140./x2)/x2)/x2)/x2)/x1/166320.+
+          (13680.-(462.-(132.-(99.-140./w2)/w2)/w2)/w2)/w/166320.))
+    return y;
+  }
+ }
+}
+
+static int rnd_binomial(XPRMcontext ctx,void *libctx)
+{
+ int n;
+ double p;
 
  n=XPRM_POP_INT(ctx);
  p=XPRM_TOP_ST(ctx)->real;
  if((n<=0)||(p<=0)||(p>=1))
-  return rnd_math_error(ctx,"pascal");
+  return rnd_math_error(ctx,"binomial");
+ else
+ {
+  XPRM_TOP_ST(ctx)->integer=binomial(libctx,n,p);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ====================================================
+ * Returns a geometric distributed non-negative integer.
+ * NOTE: use 0.0 < p < 1.0
+ * ====================================================
+ */
+static int geometric(s_rndctx *rndctx,double p)
+{ return ((int) (log(1.0 - RANDOM) / log(p))); }
+
+static int rnd_geometric(XPRMcontext ctx,void *libctx)
+{
+ double p;
+
+ p=XPRM_TOP_ST(ctx)->real;
+ if((p<=0)||(p>=1))
+  return rnd_math_error(ctx,"geometric");
+ else
+ {
+  XPRM_TOP_ST(ctx)->integer=geometric(libctx,p);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ================================================= 
+ * Returns a Pascal distributed non-negative integer. 
+ * NOTE: use n > 0 and 0.0 < p < 1.0
+ *
+ * From PASCAL_SMALLN on, the value is sampled as a gamma-Poisson
+ * mixture: Poisson(L) with L following Gamma(n, p/(1-p)).
+ * =================================================
+ */
+#define PASCAL_SMALLN 10        /* Below this value of n: sum of geometric */
+
+static int pascal(s_rndctx *rndctx,int n,double p)
+{
+ int x;
+
+ if(n<PASCAL_SMALLN)
+ {
+  x=0;
+  for(;n>0;n--)
+   x+=geometric(rndctx,p);
+  return x;
+ }
+ else
+  return poisson(rndctx,gammadev(rndctx,n)*p/(1.0-p));
+}
+
+static int rnd_pascal(XPRMcontext ctx,void *libctx)
+{
+ int n;
+ double p;
+
+ n=XPRM_POP_INT(ctx);
+ p=XPRM_TOP_ST(ctx)->real;
+ if((n<=0)||(p<=0)||(p>=1))
+  return rnd_math_error(ctx,"pascal");
+ else
+ {
+  XPRM_TOP_ST(ctx)->integer=pascal(libctx,n,p);
+  return XPRM_RT_OK;
+ }
+}
+
+/* =========================================================
+ * Returns an exponentially distributed positive real number. 
+ * NOTE: use m > 0.0
+ * =========================================================
+ */
+static double exponential(s_rndctx *rndctx,double m)
+{
+ if(rndctx->options&OPT_ZIGGURAT)
+  return (m * zig_exponential(rndctx));
+ else
+  return (-m * log(1.0 - RANDOM));
+}
+
+static int rnd_exponential(XPRMcontext ctx,void *libctx)
+{
+ double m;
+
+ m=XPRM_TOP_ST(ctx)->real;
+ if(m<=0)
+  return rnd_math_error(ctx,"exponential");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=exponential(libctx,m);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ================================================== 
+ * Returns a Poisson distributed non-negative integer. 
+ * NOTE: use m > 0
+ *
+ * From POISSON_PTRS on, the transformed rejection method with squeeze
+ * (PTRS) of Hormann (Insurance: Mathematics and Economics, 1993, vol 12,
+ * pp 39-45) is used instead of summing exponentials: its cost does not
+ * depend on m. Candidates outside [0,INT_MAX] are rejected and the
+ * result is INT_MAX when m itself exceeds this bound (Pascal mixture).
+ * ==================================================
+ */
+#define POISSON_PTRS 10         /* From this value of m: PTRS */
+
+static int poisson(s_rndctx *rndctx,double m)
+{
+  double t = 0.0;
+  int    x = 0;
+  double slam, loglam, b, a, invalpha, vr, u, v, us, kd;
+  int    k;
+
+  if (m < POISSON_PTRS) {
+    while (t < m) {
+      t += exponential(rndctx,1.0);
+      x++;
+    }
+    return ((x > 0) ? x - 1 : 0);
+  }
+  if (m >= INT_MAX)
+    return INT_MAX;
+
+  slam = sqrt(m);
+  loglam = log(m);
+  b = 0.931 + 2.53 * slam;
+  a = -0.059 + 0.02483 * b;
+  invalpha = 1.1239 + 1.1328 / (b - 3.4);
+  vr = 0.9277 - 3.6224 / (b - 2);
+  for (;;) {
+    u = RANDOM - 0.5;
+    v = RANDOM;
+    us = 0.5 - fabs(u);
+    kd = floor((2 * a / us + b) * u + m + 0.43);
+    if (!(kd >= 0) || (kd > INT_MAX))     /* Also us=0 (kd infinite) */
+      continue;
+    k = (int)kd;
+    if ((us >= 0.07) && (v <= vr))
+      return k;
+    if ((us < 0.013) && (v > us))
+      continue;
+    if ((log(v) + log(invalpha) - log(a / (us * us) + b)) <=
+        (-m + k * loglam - loggam(k + 1)))
+      return k;
+  }
+}
+
+static int rnd_poisson(XPRMcontext ctx,void *libctx)
+{
+ double m;
+
+ m=XPRM_TOP_ST(ctx)->real;
+ if(!(m>0)||(m>INT_MAX))
+  return rnd_math_error(ctx,"poisson");
+ else
+ {
+  XPRM_TOP_ST(ctx)->integer=poisson(libctx,m);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ================================================== 
+ * Returns an Erlang distributed positive real number.
+ * NOTE: use n > 0 and b > 0.0
+ * Erlang(n, b) is Gamma(n, b)
+ * ==================================================
+ */
+static double erlang(s_rndctx *rndctx,int n,double b)
+{ return b*gammadev(rndctx,n); }
+
+static int rnd_erlang(XPRMcontext ctx,void *libctx)
+{
+ int n;
+ double b;
+
+ n=XPRM_POP_INT(ctx);
+ b=XPRM_TOP_ST(ctx)->real;
+ if((n<=0)||(b<=0))
+  return rnd_math_error(ctx,"erlang");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=erlang(libctx,n,b);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ========================================================================
+ * Returns a normal (Gaussian) distributed real number.
+ * NOTE: use s > 0.0
+ *
+ * Uses a very accurate approximation of the normal idf due to Odeh & Evans, 
+ * J. Applied Statistics, 1974, vol 23, pp 96-97.
+ * ========================================================================
+ */
+static double normal(s_rndctx *rndctx,double m,double s)
+{
+  const double p0 = 0.322232431088;     const double q0 = 0.099348462606;
+  const double p1 = 1.0;                const double q1 = 0.588581570495;
+  const double p2 = 0.342242088547;     const double q2 = 0.531103462366;
+  const double p3 = 0.204231210245e-1;  const double q3 = 0.103537752850;
+  const double p4 = 0.453642210148e-4;  const double q4 = 0.385607006340e-2;
+  double u, t, p, q, z;
+
+  if (rndctx->options&OPT_ZIGGURAT)
+    return (m + s * zig_normal(rndctx));
+  u   = RANDOM;
+  if (u < 0.5)
+    t = sqrt(-2.0 * log(u));
+  else
+    t = sqrt(-2.0 * log(1.0 - u));
+  p   = p0 + t * (p1 + t * (p2 + t * (p3 + t * p4)));
+  q   = q0 + t * (q1 + t * (q2 + t * (q3 + t * q4)));
+  if (u < 0.5)
+    z = (p / q) - t;
+  else
+    z = t - (p / q);
+  return (m + s * z);
+}
+
+static int rnd_normal(XPRMcontext ctx,void *libctx)
+{
+ double m,s;
+
+ m=XPRM_POP_REAL(ctx);
+ s=XPRM_TOP_ST(ctx)->real;
+ if(s<=0)
+  return rnd_math_error(ctx,"normal");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=normal(libctx,m,s);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ==================================================================
+ * Returns a gamma distributed positive real number (shape k, scale 1).
+ * NOTE: use k > 0.0
+ *
+ * Method of Marsaglia & Tsang (ACM TOMS, 2000, vol 26, pp 363-372);
+ * for k<1 the value is obtained from Gamma(k+1) as Gamma(k+1)*U^(1/k).
+ * ==================================================================
+ */
+static double gammadev(s_rndctx *rndctx,double k)
+{
+  double d, c, x, v, u;
+
+  if (k < 1.0)
+    return (gammadev(rndctx,k + 1.0) * pow(1.0 - RANDOM, 1.0 / k));
+
+  d = k - 1.0 / 3.0;
+  c = 1.0 / sqrt(9.0 * d);
+  for (;;) {
+    do {
+      x = normal(rndctx,0.0, 1.0);
+      v = 1.0 + c * x;
+    } while (v <= 0.0);
+    v = v * v * v;
+    u = 1.0 - RANDOM;
+    if (u < 1.0 - 0.0331 * (x * x) * (x * x))
+      return (d * v);
+    if (log(u) < 0.5 * x * x + d * (1.0 - v + log(v)))
+      return (d * v);
+  }
+}
+
+static int rnd_gamma(XPRMcontext ctx,void *libctx)
+{
+ double k,t;
+
+ k=XPRM_POP_REAL(ctx);
+ t=XPRM_TOP_ST(ctx)->real;
+ if((k<=0)||(t<=0))
+  return rnd_math_error(ctx,"gamma");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=t*gammadev(libctx,k);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ==================================================================
+ * Returns a beta distributed real number between 0.0 and 1.0.
+ * NOTE: use a > 0.0 and b > 0.0
+ *
+ * Computed as X/(X+Y) with X~Gamma(a) and Y~Gamma(b) unless both
+ * shapes are below 1: Johnk's method is used in this case.
+ * ==================================================================
+ */
+static double betadev(s_rndctx *rndctx,double a,double b)
+{
+  double u, v, x, y, lx, ly, lm;
+
+  if ((a < 1.0) && (b < 1.0)) {
+    for (;;) {
+      u = RANDOM;
+      v = RANDOM;
+      x = pow(u, 1.0 / a);
+      y = pow(v, 1.0 / b);
+      if ((x + y <= 1.0) && (u + v > 0.0)) {
+        if (x + y > 0.0)
+          return (x / (x + y));
+        else {                          /* Both values underflow */
+          lx = log(u) / a;
+          ly = log(v) / b;
+          lm = (lx > ly) ? lx : ly;
+          lx -= lm;
+          ly -= lm;
+          return (exp(lx - log(exp(lx) + exp(ly))));
+        }
+      }
+    }
+  }
+  else {
+    x = gammadev(rndctx,a);
+    y = gammadev(rndctx,b);
+    return (x / (x + y));
+  }
+}
+
+static int rnd_beta(XPRMcontext ctx,void *libctx)
+{
+ double a,b;
+
+ a=XPRM_POP_REAL(ctx);
+ b=XPRM_TOP_ST(ctx)->real;
+ if((a<=0)||(b<=0))
+  return rnd_math_error(ctx,"beta");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=betadev(libctx,a,b);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ==================================================================
+ * Logarithm of the gamma function (Stirling series, shifted for x<=7)
+ * lgamma() is not used because it is not reentrant on all platforms
+ * ==================================================================
+ */
+static double loggam(double x)
+{
+  static const double a[10] = {
+     8.333333333333333e-02, -2.777777777777778e-03,
+     7.936507936507937e-04, -5.952380952380952e-04,
+     8.417508417508418e-04, -1.917526917526918e-03,
+     6.410256410256410e-03, -2.955065359477124e-02,
+     1.796443723688307e-01, -1.39243221690590e+00 };
+  double x0, x2, gl, gl0;
+  int k, n;
+
+  if ((x == 1.0) || (x == 2.0))
+    return 0.0;
+  n = 0;
+  x0 = x;
+  if (x <= 7.0) {
+    n = (int)(7 - x);
+    x0 = x + n;
+  }
+  x2 = 1.0 / (x0 * x0);
+  gl0 = a[9];
+  for (k = 8; k >= 0; k--) {
+    gl0 *= x2;
+    gl0 += a[k];
+  }
+  gl = gl0 / x0 + 0.918938533204672742 + (x0 - 0.5) * log(x0) - x0;
+  if (x <= 7.0) {
+    for (k = 1; k <= n; k++) {
+      gl -= log(x0 - 1.0);
+      x0 -= 1.0;
+    }
+  }
+  return gl;
+}
+
+/* ==================================================================
+ * Inverse of the standard normal distribution function (0 < p < 1).
+ * Rational approximation of P. J. Acklam (relative error < 1.2e-9)
+ * refined by one step of Halley's method.
+ * ==================================================================
+ */
+static double normal_icdf(double p)
+{
+  static const double a[6] = {
+    -3.969683028665376e+01,  2.209460984245205e+02, -2.759285104469687e+02,
+     1.383577518672690e+02, -3.066479806614716e+01,  2.506628277459239e+00 };
+  static const double b[5] = {
+    -5.447609879822406e+01,  1.615858368580409e+02, -1.556989798598866e+02,
+     6.680131188771972e+01, -1.328068155288572e+01 };
+  static const double c[6] = {
+    -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+    -2.549732539343734e+00,  4.374664141464968e+00,  2.938163982698783e+00 };
+  static const double d[4] = {
+     7.784695709041462e-03,  3.224671290700398e-01,  2.445134137142996e+00,
+     3.754408661907416e+00 };
+  double q, r, x, e, u;
+
+  if (p <= 0.0)
+    return (-HUGE_VAL);
+  else if (p >= 1.0)
+    return (HUGE_VAL);
+  else if (p < 0.02425) {
+    q = sqrt(-2.0 * log(p));
+    x = (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+        ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+  }
+  else if (p > 1.0 - 0.02425) {
+    q = sqrt(-2.0 * log(1.0 - p));
+    x = -(((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+         ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+  }
+  else {
+    q = p - 0.5;
+    r = q * q;
+    x = (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*q /
+        (((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1.0);
+  }
+  e = 0.5 * erfc(-x * 0.70710678118654752440) - p;
+  u = e * 2.50662827463100050242 * exp(0.5 * x * x);
+  return (x - u / (1.0 + 0.5 * x * u));
+}
+
+/* ==================================================================
+ * Returns a standard normal deviate restricted to [a,b] (a <= b).
+ * Inversion of the distribution function unless the interval is in
+ * the tail (a >= 2 after symmetry): rejection from an exponential
+ * proposal (C. P. Robert, Statistics and Computing, 1995, vol 5,
+ * pp 121-125) or from a uniform proposal if the interval is narrow.
+ * The expected number of trials is below 4 for any interval.
+ * ==================================================================
+ */
+static double truncstd(s_rndctx *rndctx,double a,double b)
+{
+  double l, z, pa, pb;
+
+  if (b <= 0.0)
+    return (-truncstd(rndctx,-b, -a));
+  if (a < 0.0) {                        /* 0 in [a,b]: use P(X<x) */
+    pa = 0.5 * erfc(-a * 0.70710678118654752440);
+    pb = 0.5 * erfc(-b * 0.70710678118654752440);
+    z = normal_icdf(pb - RANDOM * (pb - pa));
+  }
+  else if (a < 2.0) {                   /* Upper tail: use P(X>x) */
+    pa = 0.5 * erfc(a * 0.70710678118654752440);
+    pb = 0.5 * erfc(b * 0.70710678118654752440);
+    z = -normal_icdf(pa - RANDOM * (pa - pb));
+  }
+  else if ((b - a) * a <= 1.0) {        /* Narrow: uniform proposal */
+    do
+      z = a + RANDOM * (b - a);
+    while (log(1.0 - RANDOM) > 0.5 * (a - z) * (a + z));
+  }
+  else {                                /* Exponential proposal */
+    l = 0.5 * (a + sqrt(a * a + 4.0));
+    do
+      z = a - log(1.0 - RANDOM) / l;
+    while ((z > b) || (log(1.0 - RANDOM) > -0.5 * (z - l) * (z - l)));
+  }
+  return ((z < a) ? a : ((z > b) ? b : z));
+}
+
+static double truncnormal(s_rndctx *rndctx,double m,double s,double lo,
+                double hi)
+{ return (m + s * truncstd(rndctx,(lo - m) / s, (hi - m) / s)); }
+
+static int rnd_truncnormal(XPRMcontext ctx,void *libctx)
+{
+ double m,s,lo,hi;
+
+ m=XPRM_POP_REAL(ctx);
+ s=XPRM_POP_REAL(ctx);
+ lo=XPRM_POP_REAL(ctx);
+ hi=XPRM_TOP_ST(ctx)->real;
+ if((s<=0)||!(lo<=hi))
+  return rnd_math_error(ctx,"truncnormal");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=(lo<hi)?truncnormal(libctx,m,s,lo,hi):lo;
+  return XPRM_RT_OK;
+ }
+}
+
+/* ==================================================================
+ * Returns an exponential deviate of mean m restricted to [lo,hi]
+ * (inversion of the distribution function).
+ * NOTE: use m > 0.0 and 0.0 <= lo <= hi
+ * ==================================================================
+ */
+static double truncexponential(s_rndctx *rndctx,double m,double lo,
+                double hi)
+{
+  double x;
+
+  x = lo - m * log1p(RANDOM * expm1(-(hi - lo) / m));
+  return ((x > hi) ? hi : x);
+}
+
+static int rnd_truncexponential(XPRMcontext ctx,void *libctx)
+{
+ double m,lo,hi;
+
+ m=XPRM_POP_REAL(ctx);
+ lo=XPRM_POP_REAL(ctx);
+ hi=XPRM_TOP_ST(ctx)->real;
+ if((m<=0)||!(lo>=0)||!(lo<=hi))
+  return rnd_math_error(ctx,"truncexponential");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=truncexponential(libctx,m,lo,hi);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ==================================================== 
+ * Returns a lognormal distributed positive real number. 
+ * NOTE: use b > 0.0
+ * ====================================================
+ */
+static double lognormal(s_rndctx *rndctx,double a,double b)
+{ return (exp(a + b * normal(rndctx,0.0, 1.0))); }
+
+static int rnd_lognormal(XPRMcontext ctx,void *libctx)
+{
+ double a,b;
+
+ a=XPRM_POP_REAL(ctx);
+ b=XPRM_TOP_ST(ctx)->real;
+ if(b<=0)
+  return rnd_math_error(ctx,"lognormal");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=lognormal(libctx,a,b);
+  return XPRM_RT_OK;
+ }
+}
+
+/* =====================================================
+ * Returns a chi-square distributed positive real number. 
+ * NOTE: use n > 0
+ * Chisquare(n) is Gamma(n/2, 2)
+ * =====================================================
+ */
+static double chisquare(s_rndctx *rndctx,int n)
+{ return (2.0 * gammadev(rndctx,0.5 * n)); }
+
+static int rnd_chisquare(XPRMcontext ctx,void *libctx)
+{
+ int n;
+
+ n=XPRM_TOP_ST(ctx)->integer;
+ if(n<=0)
+  return rnd_math_error(ctx,"chisquare");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=chisquare(libctx,n);
+  return XPRM_RT_OK;
+ }
+}
+
+/* =========================================== 
+ * Returns a student-t distributed real number.
+ * NOTE: use n > 0
+ * ===========================================
+ */
+static double student(s_rndctx *rndctx,int n)
+{ return (normal(rndctx,0.0,1.0)/sqrt(chisquare(rndctx,n)/n)); }
+
+static int rnd_student(XPRMcontext ctx,void *libctx)
+{
+ int n;
+
+ n=XPRM_TOP_ST(ctx)->integer;
+ if(n<=0)
+  return rnd_math_error(ctx,"student");
+ else
+ {
+  XPRM_TOP_ST(ctx)->real=student(libctx,n);
+  return XPRM_RT_OK;
+ }
+}
+
+/* ========================================================================
+ * Ziggurat method of Marsaglia & Tsang (J. Statistical Software, 2000,
+ * vol 5) for the standard normal and exponential distributions, used
+ * instead of the inverse transformations when 'rnd_ziggurat' is set.
+ * 256 layers are used and each draw consumes 64 bits: the layer, the sign
+ * and the (55 or 56 bit) abscissa are taken from separate bits.
+ * The tables are computed once when the module is loaded.
+ * ========================================================================
+ */
+#define ZIG_NR 3.6541528853610088       /* Start of the tail (normal) */
+#define ZIG_NV 4.92867323399e-3         /* Area of a layer (normal) */
+#define ZIG_ER 7.69711747013104972      /* Start of the tail (exponential) */
+#define ZIG_EV 3.949659822581572e-3     /* Area of a layer (exponential) */
+
+static unsigned long long zig_kn[256],zig_ke[256];
+static double zig_wn[256],zig_fn[256],zig_we[256],zig_fe[256];
+
+/* 64 random bits */
+#define RANDOM64 ((((unsigned long long)genrand_int32(rndctx))<<32)|\
+                  genrand_int32(rndctx))
+
+/****************************/
+/* Compute the layer tables */
+/****************************/
+static void zig_init(void)
+{
+ const double m1=36028797018963968.0;  /* 2^55 */
+ const double m2=72057594037927936.0;  /* 2^56 */
+ double dn,tn,de,te,q;
+ int i;
+
+ dn=tn=ZIG_NR;
+ q=ZIG_NV/exp(-.5*dn*dn);
+ zig_kn[0]=(unsigned long long)((dn/q)*m1);
+ zig_kn[1]=0;
+ zig_wn[0]=q/m1;
+ zig_wn[255]=dn/m1;
+ zig_fn[0]=1.;
+ zig_fn[255]=exp(-.5*dn*dn);
+ for(i=254;i>=1;i--)
+ {
+  dn=sqrt(-2.*log(ZIG_NV/dn+exp(-.5*dn*dn)));
+  zig_kn[i+1]=(unsigned long long)((dn/tn)*m1);
+  tn=dn;
+  zig_fn[i]=exp(-.5*dn*dn);
+  zig_wn[i]=dn/m1;
+ }
+
+ de=te=ZIG_ER;
+ q=ZIG_EV/exp(-de);
+ zig_ke[0]=(unsigned long long)((de/q)*m2);
+ zig_ke[1]=0;
+ zig_we[0]=q/m2;
+ zig_we[255]=de/m2;
+ zig_fe[0]=1.;
+ zig_fe[255]=exp(-de);
+ for(i=254;i>=1;i--)
+ {
+  de=-log(ZIG_EV/de+exp(-de));
+  zig_ke[i+1]=(unsigned long long)((de/te)*m2);
+  te=de;
+  zig_fe[i]=exp(-de);
+  zig_we[i]=de/m2;
+ }
+}
+
+/************************************/
+/* Standard normal (mean 0, sdev 1) */
+/************************************/
+static double zig_normal(s_rndctx *rndctx)
+{
+ unsigned long long u,j;
+ double x,y;
+ int i;
+
+ for(;;)
+ {
+  u=RANDOM64;
+  i=(int)(u&255);
+  j=u>>9;
+  x=(long long)j*zig_wn[i];             /* j<2^55: signed conversion */
+  if(j<zig_kn[i])                         /* Inside the layer: accept */
+   return x*(double)(1-(int)((u>>7)&2));  /* sign from bit 8 (branchless) */
+  else
+  if(i==0)                                /* Base layer: sample the tail */
+  {
+   do
+   {
+    x=-log(1.0-RANDOM)/ZIG_NR;
+    y=-log(1.0-RANDOM);
+   } while(y+y<x*x);
+   return (u&256)?-(ZIG_NR+x):(ZIG_NR+x);
+  }
+  else                                    /* Wedge: rejection test */
+  if(zig_fn[i]+RANDOM*(zig_fn[i-1]-zig_fn[i])<exp(-.5*x*x))
+   return (u&256)?-x:x;
+ }
+}
+
+/*********************************/
+/* Standard exponential (mean 1) */
+/*********************************/
+static double zig_exponential(s_rndctx *rndctx)
+{
+ unsigned long long u,j;
+ double x;
+ int i;
+
+ for(;;)
+ {
+  u=RANDOM64;
+  i=(int)(u&255);
+  j=u>>8;
+  x=(long long)j*zig_we[i];             /* j<2^56: signed conversion */
+  if(j<zig_ke[i])                         /* Inside the layer: accept */
+   return x;
+  else
+  if(i==0)                                /* Base layer: shifted tail */
+   return ZIG_ER-log(1.0-RANDOM);
+  else                                    /* Wedge: rejection test */
+  if(zig_fe[i]+RANDOM*(zig_fe[i-1]-zig_fe[i])<exp(-x))
+   return x;
+ }
+}
+
+/******** Counter-based generation ********/
+
+/* ====================================================================
+ * crand_real(seed,i) and crand_normal(seed,i,m,s) return the value
+ * number i (i>=0) of the sequence defined by 'seed' without using nor
+ * modifying the generator state: the counter i is encrypted with
+ * Philox4x32-10 keyed with the seed. Disjoint parts of a sample can
+ * therefore be produced separately (e.g. by different workers) with
+ * the same result as a single sequential run.
+ * ====================================================================
+ */
+#define CR_TAG 0x6372616eU      /* Second half of the key ("cran") */
+
+/* 53 bit uniform from 2 words: [0,1) or (0,1) with 'ofs'=0.5 */
+#define CR_UNIF(a,b,ofs) \
+ ((((a)>>5)*67108864.0+((b)>>6)+(ofs))*(1.0/9007199254740992.0))
+
+/* The 128 random bits of value i */
+static void crand_block(int seed,int i,unsigned int *out)
+{
+ unsigned int ctr[4],key[2];
+
+ ctr[0]=(unsigned int)i;
+ ctr[1]=ctr[2]=ctr[3]=0;
+ key[0]=(unsigned int)seed;
+ key[1]=CR_TAG;
+ philox4x32(ctr,key,out);
+}
+
+static int rnd_creal(XPRMcontext ctx,void *libctx)
+{
+ unsigned int r[4];
+ int seed,i;
+
+ seed=XPRM_POP_INT(ctx);
+ i=XPRM_POP_INT(ctx);
+ if(i<0)
+  return rnd_math_error(ctx,"crand_real");
+ else
+ {
+  crand_block(seed,i,r);
+  XPRM_PUSH_REAL(ctx,CR_UNIF(r[0],r[1],0));
+  return XPRM_RT_OK;
+ }
+}
+
+/* Normal value computed with the Box-Muller transformation */
+static int rnd_cnormal(XPRMcontext ctx,void *libctx)
+{
+ unsigned int r[4];
+ int seed,i;
+ double m,s,u1,u2;
+
+ seed=XPRM_POP_INT(ctx);
+ i=XPRM_POP_INT(ctx);
+ m=XPRM_POP_REAL(ctx);
+ s=XPRM_TOP_ST(ctx)->real;
+ if((i<0)||(s<=0))
+  return rnd_math_error(ctx,"crand_normal");
+ else
+ {
+  crand_block(seed,i,r);
+  u1=CR_UNIF(r[0],r[1],0.5);
+  u2=CR_UNIF(r[2],r[3],0);
+  XPRM_TOP_ST(ctx)->real=m+s*sqrt(-2.0*log(u1))*cos(6.283185307179586477*u2);
+  return XPRM_RT_OK;
+ }
+}
+
+/******** Bulk generation ********/
+
+/* ====================================================================
+ * fillrandom(A,dist[,p1[,p2]]) assigns a random value to every true
+ * entry of the array A following the distribution 'dist' (one of the
+ * names of the single value routines). Draws are produced by blocks of
+ * RND_BLKSZ values before being stored such that the array receives
+ * exactly the values a 'forall' loop over its entries would produce.
+ * ====================================================================
+ */
+#define RND_BLKSZ 256           /* Size of the blocks of pre-generated values */
+
+#define DIST_UNIFORM0   0
+#define DIST_UNIFORM    1
+#define DIST_EQUILIKELY 2
+#define DIST_BERNOULLI  3
+#define DIST_BINOMIAL   4
+#define DIST_CHISQUARE  5
+#define DIST_ERLANG     6
+#define DIST_EXPONENTIAL 7
+#define DIST_GEOMETRIC  8
+#define DIST_LOGNORMAL  9
+#define DIST_NORMAL     10
+#define DIST_PASCAL     11
+#define DIST_POISSON    12
+#define DIST_STUDENT    13
+#define DIST_GAMMA      14
+#define DIST_BETA       15
+
+static struct
+	{
+	 const char *name;
+	 int nbpar;		/* Number of parameters */
+	 int isint;		/* Whether values are integers */
+	} tabdist[]=
+	{
+	 {"uniform",0,0},
+	 {"uniform",2,0},
+	 {"equilikely",2,1},
+	 {"bernoulli",1,1},
+	 {"binomial",2,1},
+	 {"chisquare",1,0},
+	 {"erlang",2,0},
+	 {"exponential",1,0},
+	 {"geometric",1,1},
+	 {"lognormal",2,0},
+	 {"normal",2,0},
+	 {"pascal",2,1},
+	 {"poisson",1,1},
+	 {"student",1,0},
+	 {"gamma",2,0},
+	 {"beta",2,0}
+	};
+
+#define DIST_NB (sizeof(tabdist)/sizeof(tabdist[0]))
+
+/* Check whether a real parameter can be used as a positive integer */
+#define ISPOSINT(r) (((r)>=1)&&((r)<=2147483647.0)&&((r)==floor(r)))
+/* Check whether a real parameter can be used as an integer */
+#define ISINT(r) (((r)>=-2147483648.0)&&((r)<=2147483647.0)&&((r)==floor(r)))
+
+/*****************************************************/
+/* Check the parameters of a distribution (0 if bad) */
+/*****************************************************/
+static int rnd_chkdist(int d,const double *par)
+{
+ switch(d)
+ {
+  case DIST_UNIFORM0:
+  case DIST_UNIFORM: return 1;
+  case DIST_EQUILIKELY: return ISINT(par[0])&&ISINT(par[1]);
+  case DIST_BERNOULLI:
+  case DIST_GEOMETRIC: return (par[0]>0)&&(par[0]<1);
+  case DIST_BINOMIAL:
+  case DIST_PASCAL: return ISPOSINT(par[0])&&(par[1]>0)&&(par[1]<1);
+  case DIST_CHISQUARE:
+  case DIST_STUDENT: return ISPOSINT(par[0]);
+  case DIST_ERLANG: return ISPOSINT(par[0])&&(par[1]>0);
+  case DIST_EXPONENTIAL: return par[0]>0;
+  case DIST_POISSON: return (par[0]>0)&&(par[0]<=INT_MAX);
+  case DIST_LOGNORMAL:
+  case DIST_NORMAL: return par[1]>0;
+  case DIST_GAMMA:
+  case DIST_BETA: return (par[0]>0)&&(par[1]>0);
+  default: return 0;
+ }
+}
+
+/******************************************/
+/* Generate a block of 'nb' random values */
+/******************************************/
+static void rnd_drawblock(s_rndctx *rndctx,int d,const double *par,double *buf,int nb)
+{
+ double lo,up;
+ unsigned int range;
+ int i;
+
+ switch(d)
+ {
+  case DIST_UNIFORM0:
+    for(i=0;i<nb;i++) buf[i]=genrand_res53(rndctx);
+    break;
+  case DIST_UNIFORM:
+    lo=(par[0]<par[1])?par[0]:par[1];
+    up=(par[0]<par[1])?par[1]:par[0];
+    if(lo==up)
+     for(i=0;i<nb;i++) buf[i]=lo;
+    else
+     for(i=0;i<nb;i++) buf[i]=lo+(genrand_res53(rndctx)*(up-lo));
+    break;
+  case DIST_EQUILIKELY:
+    lo=(par[0]<par[1])?par[0]:par[1];
+    up=(par[0]<par[1])?par[1]:par[0];
+    range=(unsigned int)(up-lo)+1;     /* 0: the full 32bit range */
+    if(lo==up)
+     for(i=0;i<nb;i++) buf[i]=lo;
+    else
+    if(range==0)
+     for(i=0;i<nb;i++) buf[i]=lo+genrand_int32(rndctx);
+    else
+     for(i=0;i<nb;i++) buf[i]=lo+genrand_int32(rndctx)%range;
+    break;
+  case DIST_BERNOULLI:
+    for(i=0;i<nb;i++) buf[i]=bernoulli(rndctx,par[0]);
+    break;
+  case DIST_BINOMIAL:
+    for(i=0;i<nb;i++) buf[i]=binomial(rndctx,(int)par[0],par[1]);
+    break;
+  case DIST_CHISQUARE:
+    for(i=0;i<nb;i++) buf[i]=chisquare(rndctx,(int)par[0]);
+    break;
+  case DIST_ERLANG:
+    for(i=0;i<nb;i++) buf[i]=erlang(rndctx,(int)par[0],par[1]);
+    break;
+  case DIST_EXPONENTIAL:
+    for(i=0;i<nb;i++) buf[i]=exponential(rndctx,par[0]);
+    break;
+  case DIST_GEOMETRIC:
+    for(i=0;i<nb;i++) buf[i]=geometric(rndctx,par[0]);
+    break;
+  case DIST_LOGNORMAL:
+    for(i=0;i<nb;i++) buf[i]=lognormal(rndctx,par[0],par[1]);
+    break;
+  case DIST_NORMAL:
+    for(i=0;i<nb;i++) buf[i]=normal(rndctx,par[0],par[1]);
+    break;
+  case DIST_PASCAL:
+    for(i=0;i<nb;i++) buf[i]=pascal(rndctx,(int)par[0],par[1]);
+    break;
+  case DIST_POISSON:
+    for(i=0;i<nb;i++) buf[i]=poisson(rndctx,par[0]);
+    break;
+  case DIST_STUDENT:
+    for(i=0;i<nb;i++) buf[i]=student(rndctx,(int)par[0]);
+    break;
+  case DIST_GAMMA:
+    for(i=0;i<nb;i++) buf[i]=par[1]*gammadev(rndctx,par[0]);
+    break;
+  case DIST_BETA:
+    for(i=0;i<nb;i++) buf[i]=betadev(rndctx,par[0],par[1]);
+    break;
+ }
+}
+
+/***********************************************************/
+/* Fill an array: the entry points of the 6 'fillrandom'   */
+/* versions (array of real/integer with 0, 1 or 2 params)  */
+/***********************************************************/
+static int rnd_fill0(XPRMcontext ctx,void *libctx)
+{ return rnd_fill(ctx,libctx,0,0); }
+
+static int rnd_fill1(XPRMcontext ctx,void *libctx)
+{ return rnd_fill(ctx,libctx,0,1); }
+
+static int rnd_fill2(XPRMcontext ctx,void *libctx)
+{ return rnd_fill(ctx,libctx,0,2); }
+
+static int rnd_filli0(XPRMcontext ctx,void *libctx)
+{ return rnd_fill(ctx,libctx,1,0); }
+
+static int rnd_filli1(XPRMcontext ctx,void *libctx)
+{ return rnd_fill(ctx,libctx,1,1); }
+
+static int rnd_filli2(XPRMcontext ctx,void *libctx)
+{ return rnd_fill(ctx,libctx,1,2); }
+
+static int rnd_fill(XPRMcontext ctx,s_rndctx *rndctx,int isint,int nbpar)
+{
+ XPRMarray arr;
+ const char *dname;
+ double par[2],buf[RND_BLKSZ];
+ int indices[15];
+ int d,k,nb,nbb;
+
+ arr=XPRM_POP_REF(ctx);
+ dname=XPRM_POP_REF(ctx);
+ par[0]=par[1]=0;
+ for(k=0;k<nbpar;k++)
+  par[k]=XPRM_POP_REAL(ctx);
+
+ for(d=0;d<DIST_NB;d++)
+  if((dname!=NULL)&&(strcmp(dname,tabdist[d].name)==0)&&
+     (tabdist[d].nbpar==nbpar))
+   break;
+ if(d>=DIST_NB)
+ {
+  mm->dispmsg(ctx,"RANDOM: unknown distribution `%s' with %d parameter(s) for `fillrandom'.\n",(dname!=NULL)?dname:"",nbpar);
+  return XPRM_RT_ERROR;
+ }
+ else
+ if(isint&&!tabdist[d].isint)
+ {
+  mm->dispmsg(ctx,"RANDOM: distribution `%s' cannot fill an array of integers.\n",dname);
+  return XPRM_RT_ERROR;
+ }
+ else
+ if(!rnd_chkdist(d,par))
+  return rnd_math_error(ctx,dname);
+ else
+ if((arr==NULL)||((nb=mm->getarrsize(arr))<1))
+  return XPRM_RT_OK;
+ else
+ if(mm->getarrdim(arr)>15)
+ {
+  mm->dispmsg(ctx,"RANDOM: invalid array for `fillrandom'.\n");
+  return XPRM_RT_ERROR;
+ }
+ else
+ {
+  if(mm->getfirstarrtruentry(arr,indices))
+   return XPRM_RT_OK;
+  do
+  {
+   nbb=(nb>RND_BLKSZ)?RND_BLKSZ:nb;
+   rnd_drawblock(rndctx,d,par,buf,nbb);
+   nb-=nbb;
+   for(k=0;k<nbb;k++)
+   {
+    if(isint)
+     mm->setarrvalint(ctx,arr,indices,(int)buf[k]);
+    else
+     mm->setarrvalreal(ctx,arr,indices,buf[k]);
+    if(mm->getnextarrtruentry(arr,indices))
+     return XPRM_RT_OK;
+   }
+  } while(nb>0);
+  return XPRM_RT_OK;
+ }
+}
+
+/******** Discrete distributions ********/
+
+/* ====================================================================
+ * A 'discretedist' is built from an array of weights (indexed by a range
+ * or a set of integers) and returns index values with probabilities
+ * proportional to the weights. Walker's alias tables are constructed
+ * once in O(n) (method of Vose, IEEE TSE, 1991, vol 17, pp 972-975) such
+ * that each draw takes constant time: one column is selected uniformly
+ * and either its own outcome or its alias is returned.
+ * ====================================================================
+ */
+
+/****************************************/
+/* Release the tables of a distribution */
+/****************************************/
+static void dd_clear(s_ddist *dd)
+{
+ free(dd->prob);
+ dd->prob=NULL;
+ dd->alias=dd->val=NULL;
+ dd->n=0;
+}
+
+/*****************************************************/
+/* Allocate the tables for n outcomes (0 if failure) */
+/*****************************************************/
+static int dd_alloc(XPRMcontext ctx,s_ddist *dd,int n)
+{
+ dd->prob=malloc(n*(sizeof(double)+2*sizeof(int)));
+ if(dd->prob==NULL)
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return 0;
+ }
+ else
+ {
+  dd->alias=(int *)(dd->prob+n);
+  dd->val=dd->alias+n;
+  dd->n=n;
+  return 1;
+ }
+}
+
+/**********************************/
+/* Create a discrete distribution */
+/**********************************/
+static void *dd_create(XPRMcontext ctx,void *libctx,void *todup,int typnum)
+{
+ s_ddist *dd;
+
+ if(todup!=NULL)
+ {
+  ((s_ddist *)todup)->refcnt++;
+  return todup;
+ }
+ else
+ {
+  dd=malloc(sizeof(s_ddist));
+  if(dd==NULL)
+   mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  else
+  {
+   memset(dd,0,sizeof(s_ddist));
+   dd->refcnt=1;
+  }
+  return dd;
+ }
+}
+
+/**********************************/
+/* Delete a discrete distribution */
+/**********************************/
+static void dd_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum)
+{
+ s_ddist *dd;
+
+ dd=todel;
+ if((dd!=NULL)&&(--dd->refcnt<1))
+ {
+  dd_clear(dd);
+  free(dd);
+ }
+}
+
+/***********************************/
+/* Discrete distribution -> String */
+/***********************************/
+static int dd_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,
+                int len,int typnum)
+{
+ return snprintf(str,len,"discretedist(%d)",
+                        (toprt==NULL)?0:((s_ddist *)toprt)->n);
+}
+
+/************************************************/
+/* Copy a discrete distribution (tables cloned) */
+/************************************************/
+static int dd_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,
+                int typnum)
+{
+ s_ddist *dd,*ds;
+
+ dd=toinit;
+ ds=src;
+ switch(XPRM_CPY(typnum))
+ {
+  case XPRM_CPY_COPY:
+  case XPRM_CPY_RESET:
+      if(dd==ds) return 0;
+      dd_clear(dd);
+      if((ds!=NULL)&&(ds->n>0))
+      {
+       if(!dd_alloc(ctx,dd,ds->n)) return 1;
+       memcpy(dd->prob,ds->prob,ds->n*(sizeof(double)+2*sizeof(int)));
+      }
+      return 0;
+  default:
+      return 1;
+ }
+}
+
+/*******************************************************/
+/* Build the alias tables from an array of weights     */
+/* The tables of 'dd' must be allocated for n outcomes */
+/*******************************************************/
+static int dd_build(XPRMcontext ctx,s_ddist *dd,XPRMarray arr)
+{
+ XPRMset set;
+ XPRMalltypes w,v;
+ double sum;
+ int *work;
+ int indices[15];
+ int n,i,s,l,ns,nl;
+
+ n=dd->n;
+ sum=0;
+ i=0;
+ mm->getarrsets(arr,&set);
+ mm->getfirstarrtruentry(arr,indices);
+ do
+ {
+  mm->getarrval(arr,indices,&w);
+  if(!(w.real>=0)||(w.real>1e300))      /* Negative, NaN or infinite */
+   return 0;
+  dd->prob[i]=w.real;
+  dd->val[i]=mm->getelsetval(ctx,set,indices[0],&v)->integer;
+  sum+=w.real;
+  i++;
+ } while((i<n)&&!mm->getnextarrtruentry(arr,indices));
+ if(!(sum>0))
+  return 0;
+
+ work=malloc(n*sizeof(int));            /* Small stack at the beginning, */
+ if(work==NULL)                         /* large stack at the end        */
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return 0;
+ }
+ ns=nl=0;
+ for(i=0;i<n;i++)
+ {
+  dd->prob[i]*=n/sum;
+  if(dd->prob[i]<1)
+   work[ns++]=i;
+  else
+   work[n-(++nl)]=i;
+ }
+ while((ns>0)&&(nl>0))
+ {
+  s=work[--ns];
+  l=work[n-(nl--)];
+  dd->alias[s]=l;
+  dd->prob[l]=(dd->prob[l]+dd->prob[s])-1;
+  if(dd->prob[l]<1)
+   work[ns++]=l;
+  else
+   work[n-(++nl)]=l;
+ }
+ while(nl>0)                    /* Remaining columns are full (up to */
+ {                              /* rounding errors)                  */
+  l=work[n-(nl--)];
+  dd->prob[l]=1;
+  dd->alias[l]=l;
+ }
+ while(ns>0)
+ {
+  s=work[--ns];
+  dd->prob[s]=1;
+  dd->alias[s]=s;
+ }
+ free(work);
+ return 1;
+}
+
+/******************************************************/
+/* discretedist(W): distribution from weights array W */
+/******************************************************/
+static int dd_new(XPRMcontext ctx,void *libctx)
+{
+ XPRMarray arr;
+ XPRMset set;
+ s_ddist *dd;
+ int n;
+
+ arr=XPRM_POP_REF(ctx);
+ if((arr!=NULL)&&(mm->getarrdim(arr)==1))
+  mm->getarrsets(arr,&set);
+ if((arr==NULL)||((n=mm->getarrsize(arr))<1)||(mm->getarrdim(arr)!=1)||
+    (XPRM_TYP(mm->getsettype(set))!=XPRM_TYP_INT))
+ {
+  mm->dispmsg(ctx,"RANDOM: invalid array for `discretedist'.\n");
+  return XPRM_RT_ERROR;
+ }
+ else
+ if((dd=dd_create(ctx,libctx,NULL,0))==NULL)
+  return XPRM_RT_ERROR;
+ else
+ if(!dd_alloc(ctx,dd,n))
+ {
+  dd_delete(ctx,libctx,dd,0);
+  return XPRM_RT_ERROR;
+ }
+ else
+ if(!dd_build(ctx,dd,arr))
+ {
+  dd_delete(ctx,libctx,dd,0);
+  return rnd_math_error(ctx,"discretedist");
+ }
+ else
+ {
+  XPRM_PUSH_REF(ctx,dd);
+  return XPRM_RT_OK;
+ }
+}
+
+/*******************************************/
+/* Draw an outcome of a distribution (n>0) */
+/*******************************************/
+static int dd_draw(s_rndctx *rndctx,s_ddist *dd)
+{
+ double u;
+ int i;
+
+ u=RANDOM*dd->n;
+ i=(int)u;
+ return dd->val[(u-i<dd->prob[i])?i:dd->alias[i]];
+}
+
+static int dd_discrete(XPRMcontext ctx,void *libctx)
+{
+ s_ddist *dd;
+
+ dd=XPRM_POP_REF(ctx);
+ if((dd==NULL)||(dd->n<1))
+  return rnd_math_error(ctx,"discrete");
+ else
+ {
+  XPRM_PUSH_INT(ctx,dd_draw(libctx,dd));
+  return XPRM_RT_OK;
+ }
+}
+
+/**********************************************/
+/* fillrandom(A,d): an outcome for each entry */
+/**********************************************/
+static int dd_fill(XPRMcontext ctx,void *libctx)
+{
+ XPRMarray arr;
+ s_ddist *dd;
+ int indices[15];
+
+ arr=XPRM_POP_REF(ctx);
+ dd=XPRM_POP_REF(ctx);
+ if((dd==NULL)||(dd->n<1))
+  return rnd_math_error(ctx,"fillrandom");
+ else
+ if((arr==NULL)||(mm->getarrsize(arr)<1))
+  return XPRM_RT_OK;
+ else
+ if(mm->getarrdim(arr)>15)
+ {
+  mm->dispmsg(ctx,"RANDOM: invalid array for `fillrandom'.\n");
+  return XPRM_RT_ERROR;
+ }
+ else
+ {
+  if(!mm->getfirstarrtruentry(arr,indices))
+   do
+   {
+    mm->setarrvalint(ctx,arr,indices,dd_draw(libctx,dd));
+   } while(!mm->getnextarrtruentry(arr,indices));
+  return XPRM_RT_OK;
+ }
+}
+
+/******** Low-discrepancy sequences ********/
+
+/* ====================================================================
+ * A 'qmcseq' returns the successive points of a quasi-random sequence
+ * of dimension d in [0,1)^d. Sobol points are generated in Gray code
+ * order (Antonov & Saleev) with the direction numbers of S. Joe and
+ * F. Y. Kuo (new-joe-kuo-6.21201, SIAM J. Sci. Comput. 30, 2008,
+ * pp 2635-2654), the initial point 0 being skipped. For the Halton
+ * sequence the digits of dimension j (in base the j-th prime) are
+ * scrambled by a random multiplier: this removes the correlations
+ * between dimensions of the plain sequence.
+ * ====================================================================
+ */
+
+/* Primitive polynomials (including the x^s and 1 terms) of dimensions */
+/* 2 to QMC_MAXDIM, each followed by its s initial direction numbers    */
+static const unsigned short sb_tab[]={
+ 3,1,7,1,3,11,1,3,1,13,1,1,1,19,1,1,3,3,25,1,3,5,13,37,1,1,5,5,17,41,1,1,5,5,
+ 5,47,1,1,7,11,19,55,1,1,5,1,1,59,1,1,1,3,11,61,1,3,5,5,31,67,1,3,3,9,7,49,91,
+ 1,1,1,15,21,21,97,1,3,1,13,27,49,103,1,1,1,15,7,5,109,1,3,1,15,13,25,115,1,1,
+ 5,5,19,61,131,1,3,7,11,23,15,103,137,1,3,7,13,13,15,69,143,1,1,3,13,7,35,63,
+ 145,1,3,5,9,1,25,53,157,1,3,1,13,9,35,107,167,1,3,1,5,27,61,31,171,1,1,5,11,
+ 19,41,61,185,1,3,5,3,3,13,69,191,1,1,7,13,1,19,1,193,1,3,7,5,13,19,59,203,1,
+ 1,3,9,25,29,41,211,1,3,5,13,23,1,55,213,1,3,7,3,13,59,17,229,1,3,1,3,5,53,69,
+ 239,1,1,5,5,23,33,13,241,1,1,7,7,1,61,123,247,1,1,7,9,13,61,49,253,1,3,3,5,3,
+ 55,33,285,1,3,1,15,31,13,49,245,299,1,3,5,15,31,59,63,97,301,1,3,1,11,11,11,
+ 77,249,333,1,3,1,11,27,43,71,9,351,1,1,7,15,21,11,81,45,355,1,3,7,3,25,31,65,
+ 79,357,1,3,1,1,19,11,3,205,361,1,1,5,9,19,21,29,157,369,1,3,7,11,1,33,89,185,
+ 391,1,3,3,3,15,9,79,71,397,1,3,7,11,15,39,119,27,425,1,1,3,1,11,31,97,225,
+ 451,1,1,1,3,23,43,57,177,463,1,3,7,7,17,17,37,71,487,1,3,1,5,27,63,123,213,
+ 501,1,1,3,5,11,43,53,133,529,1,3,5,5,29,17,47,173,479,539,1,3,3,11,3,1,109,9,
+ 69,545,1,1,1,5,17,39,23,5,343,557,1,3,1,5,25,15,31,103,499,563,1,1,1,11,11,
+ 17,63,105,183,601,1,1,5,11,9,29,97,231,363,607,1,1,5,15,19,45,41,7,383,617,1,
+ 3,7,7,31,19,83,137,221,623,1,1,1,3,23,15,111,223,83,631,1,1,5,13,31,15,55,25,
+ 161,637,1,1,3,13,25,47,39,87,257,647,1,1,1,11,21,53,125,249,293,661,1,1,7,11,
+ 11,7,57,79,323,675,1,1,5,5,17,13,81,3,131,677,1,1,7,13,23,7,65,251,475,687,1,
+ 3,5,1,9,43,3,149,11,695,1,1,3,13,31,13,13,255,487,701,1,3,3,1,5,63,89,91,127,
+ 719,1,1,3,3,1,19,123,127,237,721,1,1,5,7,23,31,37,243,289,731,1,1,5,11,17,53,
+ 117,183,491,757,1,1,1,5,1,13,13,209,345,761,1,1,3,15,1,57,115,7,33,787,1,3,1,
+ 11,7,43,81,207,175,789,1,3,1,1,15,27,63,255,49,799,1,3,5,3,27,61,105,171,305,
+ 803,1,1,5,3,1,3,57,249,149,817,1,1,3,5,5,57,15,13,159,827,1,1,1,11,7,11,105,
+ 141,225,847,1,3,3,5,27,59,121,101,271,859,1,3,5,9,11,49,51,59,115,865,1,1,7,
+ 1,23,45,125,71,419,875,1,1,3,5,23,5,105,109,75,877,1,1,7,15,7,11,67,121,453,
+ 883,1,3,7,3,9,13,31,27,449,895,1,3,1,15,19,39,39,89,15,901,1,1,1,1,1,33,73,
+ 145,379,911,1,3,1,15,15,43,29,13,483,949,1,1,7,3,19,27,85,131,431,953,1,3,3,
+ 3,5,35,23,195,349,967,1,3,3,7,9,27,39,59,297,971,1,1,3,9,11,17,13,241,157,
+ 973,1,3,7,15,25,57,33,189,213,981,1,1,7,1,9,55,73,83,217,985,1,3,3,13,19,27,
+ 23,113,249,995,1,3,5,3,23,43,3,253,479,1001,1,1,5,5,11,5,45,117,217,1019,1,3,
+ 3,7,29,37,33,123,147,1033,1,3,1,15,5,5,37,227,223,459,1051,1,1,7,5,5,39,63,
+ 255,135,487,1063,1,3,1,7,9,7,87,249,217,599,1069,1,1,3,13,9,47,7,225,363,247,
+ 1125,1,3,7,13,19,13,9,67,9,737,1135,1,3,5,5,19,59,7,41,319,677,1153,1,1,5,3,
+ 31,63,15,43,207,789,1163,1,1,7,9,13,39,3,47,497,169,1221,1,3,1,7,21,17,97,19,
+ 415,905,1239,1,3,7,1,3,31,71,111,165,127,1255,1,1,5,11,1,61,83,119,203,847,
+ 1267,1,3,3,13,9,61,19,97,47,35,1279,1,1,7,7,15,29,63,95,417,469,1293,1,3,1,9,
+ 25,9,71,57,213,385,1305,1,3,5,13,31,47,101,57,39,341,1315,1,1,3,3,31,57,125,
+ 173,365,551,1329,1,3,7,1,13,57,67,157,451,707,1341,1,1,1,7,21,13,105,89,429,
+ 965,1347,1,1,5,9,17,51,45,119,157,141,1367,1,3,7,7,13,45,91,9,129,741,1387,1,
+ 3,7,1,23,57,67,141,151,571,1413,1,1,3,11,17,47,93,107,375,157,1423,1,3,3,5,
+ 11,21,43,51,169,915,1431,1,1,5,3,15,55,101,67,455,625,1441,1,3,5,9,1,23,29,
+ 47,345,595,1479,1,3,7,7,5,49,29,155,323,589,1509,1,3,3,7,5,41,127,61,261,717,
+ 1527,1,3,7,7,17,23,117,67,129,1009,1531,1,1,3,13,11,39,21,207,123,305,1555,1,
+ 1,3,9,29,3,95,47,231,73,1557,1,3,1,9,1,29,117,21,441,259,1573,1,3,1,13,21,39,
+ 125,211,439,723,1591,1,1,7,3,17,63,115,89,49,773,1603,1,3,7,13,11,33,101,107,
+ 63,73,1615,1,1,5,5,13,57,63,135,437,177,1627,1,1,3,7,27,63,93,47,417,483,
+ 1657,1,1,3,1,23,29,1,191,49,23,1663,1,1,3,15,25,55,9,101,219,607,1673,1,3,1,
+ 7,7,19,51,251,393,307,1717,1,3,3,3,25,55,17,75,337,3,1729,1,1,1,13,25,17,65,
+ 45,479,413,1747,1,1,7,7,27,49,99,161,213,727,1759,1,3,5,1,23,5,43,41,251,857,
+ 1789,1,3,3,7,11,61,39,87,383,835,1815,1,1,3,15,13,7,29,7,505,923,1821,1,3,7,
+ 1,5,31,47,157,445,501,1825,1,1,3,7,1,43,9,147,115,605,1849,1,3,3,13,5,1,119,
+ 211,455,1001,1863,1,1,3,5,13,19,3,243,75,843,1869,1,3,7,7,1,19,91,249,357,
+ 589,1877,1,1,1,9,1,25,109,197,279,411,1881,1,3,1,15,23,57,59,135,191,75,1891,
+ 1,1,5,15,29,21,39,253,383,349,1917,1,3,3,5,19,45,61,151,199,981,1933,1,3,5,
+ 13,9,61,107,141,141,1,1939,1,3,1,11,27,25,85,105,309,979,1969,1,3,3,11,19,7,
+ 115,223,349,43,2011,1,1,7,9,21,39,123,21,275,927,2035,1,1,7,13,15,41,47,243,
+ 303,437,2041,1,1,1,7,7,3,15,99,409,719,2053,1,3,3,15,27,49,113,123,113,67,
+ 469,2071,1,3,7,11,3,23,87,169,119,483,199,2091,1,1,5,15,7,17,109,229,179,213,
+ 741,2093,1,1,5,13,11,17,25,135,403,557,1433,2119,1,3,1,1,1,61,67,215,189,945,
+ 1243,2147,1,1,7,13,17,33,9,221,429,217,1679,2149,1,1,3,11,27,3,15,93,93,865,
+ 1049,2161,1,3,7,7,25,41,121,35,373,379,1547,2171,1,3,3,9,11,35,45,205,241,9,
+ 59,2189,1,3,1,7,3,51,7,177,53,975,89,2197,1,1,3,5,27,1,113,231,299,759,861,
+ 2207,1,3,3,15,25,29,5,255,139,891,2031,2217,1,3,1,1,13,9,109,193,419,95,17,
+ 2225,1,1,7,9,3,7,29,41,135,839,867,2255,1,1,7,9,25,49,123,217,113,909,215,
+ 2257,1,1,7,3,23,15,43,133,217,327,901,2273,1,1,3,3,13,53,63,123,477,711,1387,
+ 2279,1,1,3,15,7,29,75,119,181,957,247,2283,1,1,1,11,27,25,109,151,267,99,
+ 1461,2293,1,3,7,15,5,5,53,145,11,725,1501,2317,1,3,7,1,9,43,71,229,157,607,
+ 1835,2323,1,3,3,13,25,1,5,27,471,349,127,2341,1,1,1,1,23,37,9,221,269,897,
+ 1685,2345,1,1,3,3,31,29,51,19,311,553,1969,2363,1,3,7,5,5,55,17,39,475,671,
+ 1529,2365,1,1,7,1,1,35,47,27,437,395,1635,2373,1,1,7,3,13,23,43,135,327,139,
+ 389,2377,1,3,7,3,9,25,91,25,429,219,513,2385,1,1,3,5,13,29,119,201,277,157,
+ 2043,2395,1,3,5,3,29,57,13,17,167,739,1031,2419,1,3,3,5,29,21,95,27,255,679,
+ 1531,2421,1,3,7,15,9,5,21,71,61,961,1201,2431,1,3,5,13,15,57,33,93,459,867,
+ 223,2435,1,1,1,15,17,43,127,191,67,177,1073,2447,1,1,1,15,23,7,21,199,75,293,
+ 1611,2475,1,3,7,13,15,39,21,149,65,741,319,2477,1,3,7,11,23,13,101,89,277,
+ 519,711,2489,1,3,7,15,19,27,85,203,441,97,1895,2503,1,3,1,3,29,25,21,155,11,
+ 191,197,2521,1,1,7,5,27,11,81,101,457,675,1687,2533,1,3,1,5,25,5,65,193,41,
+ 567,781,2551,1,3,1,5,11,15,113,77,411,695,1111,2561,1,1,3,9,11,53,119,171,55,
+ 297,509,2567,1,1,1,1,11,39,113,139,165,347,595,2579,1,3,7,11,9,17,101,13,81,
+ 325,1733,2581,1,3,1,1,21,43,115,9,113,907,645,2601,1,1,7,3,9,25,117,197,159,
+ 471,475,2633,1,3,1,9,11,21,57,207,485,613,1661,2657,1,1,7,7,27,55,49,223,89,
+ 85,1523,2669,1,1,5,3,19,41,45,51,447,299,1355,2681,1,3,1,13,1,33,117,143,313,
+ 187,1073,2687,1,1,7,7,5,11,65,97,377,377,1501,2693,1,3,1,1,21,35,95,65,99,23,
+ 1239,2705,1,1,5,9,3,37,95,167,115,425,867,2717,1,3,3,13,1,37,27,189,81,679,
+ 773,2727,1,1,3,11,1,61,99,233,429,969,49,2731,1,1,1,7,25,63,99,165,245,793,
+ 1143,2739,1,1,5,11,11,43,55,65,71,283,273,2741,1,1,5,5,9,3,101,251,355,379,
+ 1611,2773,1,1,1,15,21,63,85,99,49,749,1335,2783,1,1,5,13,27,9,121,43,255,715,
+ 289,2793,1,3,1,5,27,19,17,223,77,571,1415,2799,1,1,5,3,13,59,125,251,195,551,
+ 1737,2801,1,3,3,15,13,27,49,105,389,971,755,2811,1,3,5,15,23,43,35,107,447,
+ 763,253,2819,1,3,5,11,21,3,17,39,497,407,611,2825,1,1,7,13,15,31,113,17,23,
+ 507,1995,2833,1,1,7,15,3,15,31,153,423,79,503,2867,1,1,7,9,19,25,23,171,505,
+ 923,1989,2879,1,1,5,9,21,27,121,223,133,87,697,2881,1,1,5,5,9,19,107,99,319,
+ 765,1461,2891,1,1,3,3,19,25,3,101,171,729,187,2905,1,1,3,1,13,23,85,93,291,
+ 209,37,2911,1,1,1,15,25,25,77,253,333,947,1073,2917,1,1,3,9,17,29,55,47,255,
+ 305,2037,2927,1,3,3,9,29,63,9,103,489,939,1523,2941,1,3,7,15,7,31,89,175,369,
+ 339,595,2951,1,3,7,13,25,5,71,207,251,367,665,2955,1,3,3,3,21,25,75,35,31,
+ 321,1603,2963,1,1,1,9,11,1,65,5,11,329,535,2965,1,1,5,3,19,13,17,43,379,485,
+ 383,2991,1,3,5,13,13,9,85,147,489,787,1133,2999,1,3,1,1,5,51,37,129,195,297,
+ 1783,3005,1,1,3,15,19,57,59,181,455,697,2033,3017,1,3,7,1,27,9,65,145,325,
+ 189,201,3035,1,3,1,15,31,23,19,5,485,581,539,3037,1,1,7,13,11,15,65,83,185,
+ 847,831,3047,1,3,5,7,7,55,73,15,303,511,1905,3053,1,3,5,9,7,21,45,15,397,385,
+ 597,3083,1,3,7,3,23,13,73,221,511,883,1265,3085,1,1,3,11,1,51,73,185,33,975,
+ 1441,3097,1,3,3,9,19,59,21,39,339,37,143,3103,1,1,7,1,31,33,19,167,117,635,
+ 639,3159,1,1,1,3,5,13,59,83,355,349,1967,3169,1,1,1,5,19,3,53,133,97,863,983,
+ 3179,1,3,1,13,9,41,91,105,173,97,625,3187,1,1,5,3,7,49,115,133,71,231,1063,
+ 3205,1,1,7,5,17,43,47,45,497,547,757,3209,1,3,5,15,21,61,123,191,249,31,631,
+ 3223,1,3,7,9,17,7,11,185,127,169,1951,3227,1,1,5,13,11,11,9,49,29,125,791,
+ 3229,1,1,1,15,31,41,13,167,273,429,57,3251,1,3,5,3,27,7,35,209,65,265,1393,
+ 3263,1,3,1,13,31,19,53,143,135,9,1021,3271,1,1,7,13,31,5,115,153,143,957,623,
+ 3277,1,1,5,11,25,19,29,31,297,943,443,3283,1,3,3,5,21,11,127,81,479,25,699,
+ 3285,1,1,3,11,25,31,97,19,195,781,705,3299,1,1,5,5,31,11,75,207,197,885,2037,
+ 3305,1,1,1,11,9,23,29,231,307,17,1497,3319,1,1,5,11,11,43,111,233,307,523,
+ 1259,3331,1,1,7,5,1,21,107,229,343,933,217,3343,1,1,1,11,3,21,125,131,405,
+ 599,1469,3357,1,3,5,5,9,39,33,81,389,151,811,3367,1,1,7,7,7,1,59,223,265,529,
+ 2021,3373,1,3,1,3,9,23,85,181,47,265,49,3393,1,3,5,11,19,23,9,7,157,299,1983,
+ 3399,1,3,1,5,15,5,21,105,29,339,1041,3413,1,1,1,1,5,33,65,85,111,705,479,
+ 3417,1,1,1,7,9,35,77,87,151,321,101,3427,1,1,5,7,17,1,51,197,175,811,1229,
+ 3439,1,3,3,15,23,37,85,185,239,543,731,3441,1,3,1,7,7,55,111,109,289,439,243,
+ 3475,1,1,7,11,17,53,35,217,259,853,1667,3487,1,3,1,9,1,63,87,17,73,565,1091,
+ 3497,1,1,3,3,11,41,1,57,295,263,1029,3515,1,1,5,1,27,45,109,161,411,421,1395,
+ 3517,1,3,5,11,25,35,47,191,339,417,1727,3529,1,1,5,15,21,1,93,251,351,217,
+ 1767,3543,1,3,3,11,3,7,75,155,313,211,491,3547,1,3,3,5,11,9,101,161,453,913,
+ 1067,3553,1,1,3,1,15,45,127,141,163,727,1597,3559,1,3,3,7,1,33,63,73,73,341,
+ 1691,3573,1,3,5,13,15,39,53,235,77,99,949,3589,1,1,5,13,31,17,97,13,215,301,
+ 1927,3613,1,1,7,1,1,37,91,93,441,251,1131,3617,1,3,7,9,25,5,105,69,81,943,
+ 1459,3623,1,3,7,11,31,43,13,209,27,1017,501,3627,1,1,7,15,1,33,31,233,161,
+ 507,387,3635,1,3,3,5,5,53,33,177,503,627,1927,3641,1,1,7,11,7,61,119,31,457,
+ 229,1875,3655,1,1,5,15,19,5,53,201,157,885,1057,3659,1,3,7,9,1,35,51,113,249,
+ 425,1009,3669,1,3,5,7,21,53,37,155,119,345,631,3679,1,3,5,7,15,31,109,69,503,
+ 595,1879,3697,1,3,3,1,25,35,65,131,403,705,503,3707,1,3,7,7,19,33,11,153,45,
+ 633,499,3709,1,3,3,5,11,3,29,93,487,33,703,3713,1,1,3,15,21,53,107,179,387,
+ 927,1757,3731,1,1,3,7,21,45,51,147,175,317,361,3743,1,1,1,7,7,13,15,243,269,
+ 795,1965,3747,1,1,3,5,19,33,57,115,443,537,627,3771,1,3,3,9,3,39,25,61,185,
+ 717,1049,3791,1,3,7,3,7,37,107,153,7,269,1581,3805,1,1,7,3,7,41,91,41,145,
+ 489,1245,3827,1,1,5,9,7,7,105,81,403,407,283,3833,1,1,7,9,27,55,29,77,193,
+ 963,949,3851,1,1,5,3,25,51,107,63,403,917,815,3865,1,1,7,3,7,61,19,51,457,
+ 599,535,3889,1,3,7,1,23,51,105,153,239,215,1847,3895,1,1,3,5,27,23,79,49,495,
+ 45,1935,3933,1,1,1,11,11,47,55,133,495,999,1461,3947,1,1,3,15,27,51,93,17,
+ 355,763,1675,3949,1,3,1,3,1,3,79,119,499,17,995,3957,1,1,1,1,15,43,45,17,167,
+ 973,799,3971,1,1,1,3,27,49,89,29,483,913,2023,3985,1,1,3,3,5,11,75,7,41,851,
+ 611,3991,1,3,1,3,7,57,39,123,257,283,507,3995,1,3,3,11,27,23,113,229,187,299,
+ 133,4007,1,1,3,13,9,63,101,77,451,169,337,4013,1,3,7,3,3,59,45,195,229,415,
+ 409,4021,1,3,5,3,11,19,71,93,43,857,369,4045,1,3,7,9,19,33,115,19,241,703,
+ 247,4051,1,3,5,11,5,35,21,155,463,1005,1073,4069,1,3,7,3,25,15,109,83,93,69,
+ 1189,4073,1,3,5,7,5,21,93,133,135,167,903,4179,1,1,7,7,3,59,121,161,285,815,
+ 1769,3705,4201,1,3,1,1,3,47,103,171,381,609,185,373,4219,1,3,3,15,23,33,107,
+ 131,441,445,689,2059,4221,1,3,3,11,7,53,101,167,435,803,1255,3781,4249,1,1,5,
+ 11,15,59,41,19,135,835,1263,505,4305,1,1,7,11,21,49,23,219,127,961,1065,385,
+ 4331,1,3,5,15,7,47,117,217,45,731,1639,733,4359,1,1,7,11,27,57,91,87,81,35,
+ 1269,1007,4383,1,1,3,11,15,37,53,219,193,937,1899,3733,4387,1,3,5,3,13,11,27,
+ 19,199,393,965,2195,4411,1,3,1,3,5,1,37,173,413,1023,553,409,4431,1,3,1,7,15,
+ 29,123,95,255,373,1799,3841,4439,1,3,5,13,21,57,51,17,511,195,1157,1831,4449,
+ 1,1,1,15,29,19,7,73,295,519,587,3523,4459,1,1,5,13,13,35,115,191,123,535,717,
+ 1661,4485,1,3,3,5,23,21,47,251,379,921,1119,297,4531,1,3,3,9,29,53,121,201,
+ 135,193,523,2943,4569,1,1,1,7,29,45,125,9,99,867,425,601,4575,1,3,1,9,13,15,
+ 67,181,109,293,1305,3079,4621,1,3,3,9,5,35,15,209,305,87,767,2795,4663,1,3,3,
+ 11,27,57,113,123,179,643,149,523,4669,1,1,3,15,11,17,67,223,63,657,335,3309,
+ 4711,1,1,1,9,25,29,109,159,39,513,571,1761,4723,1,1,3,1,5,63,75,19,455,601,
+ 123,691,4735,1,1,1,3,21,5,45,169,377,513,1951,2565,4793,1,1,3,11,3,33,119,69,
+ 253,907,805,1449,4801,1,1,5,13,31,15,17,7,499,61,687,1867,4811,1,3,7,11,17,
+ 33,73,77,299,243,641,2345,4879,1,1,7,11,9,35,31,235,359,647,379,1161,4893,1,
+ 3,3,15,31,25,5,67,33,45,437,4067,4897,1,1,3,11,7,17,37,87,333,253,1517,2921,
+ 4921,1,1,7,15,7,15,107,189,153,769,1521,3427,4927,1,3,5,13,5,61,113,37,293,
+ 393,113,43,4941,1,1,1,15,29,43,107,31,167,147,301,1021,4977,1,1,1,13,3,1,35,
+ 93,195,181,2027,1491,5017,1,3,3,3,13,33,77,199,153,221,1699,3671,5027,1,3,5,
+ 13,7,49,123,155,495,681,819,809,5033,1,3,5,15,27,61,117,189,183,887,617,4053,
+ 5127,1,1,1,7,31,59,125,235,389,369,447,1039,5169,1,3,5,1,5,39,115,89,249,377,
+ 431,3747,5175,1,1,1,5,7,47,59,157,77,445,699,3439,5199,1,1,3,5,11,21,19,75,
+ 11,599,1575,735,5213,1,3,5,3,19,13,41,69,199,143,1761,3215,5223,1,3,5,7,19,
+ 43,25,41,41,11,1647,2783,5237,1,3,1,9,19,45,111,97,405,399,457,3219,5287,1,1,
+ 3,1,23,15,65,121,59,985,829,2259,5293,1,1,3,7,17,13,107,229,75,551,1299,2363,
+ 5331,1,1,5,5,21,57,23,199,509,139,2007,3875,5391,1,3,1,11,19,53,15,229,215,
+ 741,695,823,5405,1,3,7,1,29,3,17,163,417,559,549,319,5453,1,3,1,13,17,9,47,
+ 133,365,7,1937,1071,5523,1,3,5,7,19,37,55,163,301,249,689,2327,5573,1,3,5,13,
+ 11,23,61,205,257,377,615,1457,5591,1,3,5,1,23,37,13,75,331,495,579,3367,5597,
+ 1,1,1,9,1,23,49,129,475,543,883,2531,5611,1,3,1,5,23,59,51,35,343,695,219,
+ 369,5641,1,3,3,1,27,17,63,97,71,507,1929,613,5703,1,1,5,1,21,31,11,109,247,
+ 409,1817,2173,5717,1,1,3,15,23,9,7,209,301,23,147,1691,5721,1,1,7,5,5,19,37,
+ 229,249,277,1115,2309,5797,1,1,1,5,5,63,5,249,285,431,343,2467,5821,1,1,1,11,
+ 7,45,35,75,505,537,29,2919,5909,1,3,5,15,11,39,15,63,263,9,199,445,5913,1,3,
+ 3,3,27,63,53,171,227,63,1049,827,5955,1,1,3,13,7,11,115,183,179,937,1785,381,
+ 5957,1,3,1,11,13,15,107,81,53,295,1785,3757,6005,1,3,3,13,11,5,109,243,3,505,
+ 323,1373,6025,1,3,3,11,21,51,17,177,381,937,1263,3889,6061,1,3,5,9,27,25,85,
+ 193,143,573,1189,2995,6067,1,3,5,11,13,9,81,21,159,953,91,1751,6079,1,1,3,3,
+ 27,61,11,253,391,333,1105,635,6081,1,3,3,15,9,57,95,81,419,735,251,1141,6231,
+ 1,1,5,9,31,39,59,13,319,807,1241,2433,6237,1,3,3,5,27,13,107,141,423,937,
+ 2027,3233,6289,1,3,3,9,9,25,125,23,443,835,1245,847,6295,1,1,7,15,17,17,83,
+ 107,411,285,847,1571,6329,1,1,3,13,29,61,37,81,349,727,1453,1957,6383,1,3,7,
+ 11,31,13,59,77,273,591,1265,1533,6427,1,1,7,7,13,17,25,25,187,329,347,1473,
+ 6453,1,3,7,7,5,51,37,99,221,153,503,2583,6465,1,3,1,13,19,27,11,69,181,479,
+ 1183,3229,6501,1,3,3,13,23,21,103,147,323,909,947,315,6523,1,3,1,3,23,1,31,
+ 59,93,513,45,2271,6539,1,3,5,1,7,43,109,59,231,41,1515,2385,6577,1,3,1,5,31,
+ 57,49,223,283,1013,11,701,6589,1,1,5,1,19,53,55,31,31,299,495,693,6601,1,3,3,
+ 9,5,33,77,253,427,791,731,1019,6607,1,3,7,11,1,9,119,203,53,877,1707,3499,
+ 6631,1,1,3,7,13,39,55,159,423,113,1653,3455,6683,1,1,3,5,21,47,51,59,55,411,
+ 931,251,6699,1,3,7,3,31,25,81,115,405,239,741,455,6707,1,1,5,1,31,3,101,83,
+ 479,491,1779,2225,6761,1,3,3,3,9,37,107,161,203,503,767,3435,6795,1,3,7,9,1,
+ 27,61,119,233,39,1375,4089,6865,1,1,5,9,1,31,45,51,369,587,383,2813,6881,1,3,
+ 7,5,31,7,49,119,487,591,1627,53,6901,1,1,7,1,9,47,1,223,369,711,1603,1917,
+ 6923,1,3,5,3,21,37,111,17,483,739,1193,2775,6931,1,3,3,7,17,11,51,117,455,
+ 191,1493,3821,6943,1,1,5,9,23,39,99,181,343,485,99,1931,6999,1,3,1,7,29,49,
+ 31,71,489,527,1763,2909,7057,1,1,5,11,5,5,73,189,321,57,1191,3685,7079,1,1,5,
+ 15,13,45,125,207,371,415,315,983,7103,1,3,3,5,25,59,33,31,239,919,1859,2709,
+ 7105,1,3,5,13,27,61,23,115,61,413,1275,3559,7123,1,3,7,15,5,59,101,81,47,967,
+ 809,3189,7173,1,1,5,11,31,15,39,25,173,505,809,2677,7185,1,1,5,9,19,13,95,89,
+ 511,127,1395,2935,7191,1,1,5,5,31,45,9,57,91,303,1295,3215,7207,1,3,3,3,19,
+ 15,113,187,217,489,1285,1803,7245,1,1,3,1,13,29,57,139,255,197,537,2183,7303,
+ 1,3,1,15,11,7,53,255,467,9,757,3167,7327,1,3,3,15,21,13,9,189,359,323,49,333,
+ 7333,1,3,7,11,7,37,21,119,401,157,1659,1069,7355,1,1,5,7,17,33,115,229,149,
+ 151,2027,279,7365,1,1,5,15,5,49,77,155,383,385,1985,945,7369,1,3,7,3,7,55,85,
+ 41,357,527,1715,1619,7375,1,1,3,1,21,45,115,21,199,967,1581,3807,7411,1,1,3,
+ 7,21,39,117,191,169,73,413,3417,7431,1,1,1,13,1,31,57,195,231,321,367,1027,
+ 7459,1,3,7,3,11,29,47,161,71,419,1721,437,7491,1,1,7,3,11,9,43,65,157,1,1851,
+ 823,7505,1,1,1,5,21,15,31,101,293,299,127,1321,7515,1,1,7,1,27,1,11,229,241,
+ 705,43,1475,7541,1,3,7,1,5,15,73,183,193,55,1345,49,7557,1,3,3,3,19,3,55,21,
+ 169,663,1675,137,7561,1,1,1,13,7,21,69,67,373,965,1273,2279,7701,1,1,7,7,21,
+ 23,17,43,341,845,465,3355,7705,1,3,5,5,25,5,81,101,233,139,359,2057,7727,1,1,
+ 3,11,15,39,55,3,471,765,1143,3941,7749,1,1,7,15,9,57,81,79,215,433,333,3855,
+ 7761,1,1,5,5,19,45,83,31,209,363,701,1303,7783,1,3,7,5,1,13,55,163,435,807,
+ 287,2031,7795,1,3,3,7,3,3,17,197,39,169,489,1769,7823,1,1,3,5,29,43,87,161,
+ 289,339,1233,2353,7907,1,3,3,9,21,9,77,1,453,167,1643,2227,7953,1,1,7,1,15,7,
+ 67,33,193,241,1031,2339,7963,1,3,1,11,1,63,45,65,265,661,849,1979,7975,1,3,1,
+ 13,19,49,3,11,159,213,659,2839,8049,1,3,5,11,9,29,27,227,253,449,1403,3427,
+ 8089,1,1,3,1,7,3,77,143,277,779,1499,475,8123,1,1,1,5,11,23,87,131,393,849,
+ 193,3189,8125,1,3,5,11,3,3,89,9,449,243,1501,1739,8137,1,3,1,9,29,29,113,15,
+ 65,611,135,3687,8219,1,1,1,9,21,19,39,151,395,501,1339,959,2725,8231,1,3,7,1,
+ 7,35,45,33,119,225,1631,1695,1459,8245,1,1,1,3,25,55,37,79,167,907,1075,271,
+ 4059,8275,1,3,5,13,5,13,53,165,437,67,1705,3177,8095,8293,1,3,3,13,27,57,95,
+ 55,443,245,1945,1725,1929,8303,1,3,1,9,5,33,109,35,99,827,341,2401,2411,8331,
+ 1,1,5,9,7,33,43,39,87,799,635,3481,7159,8333,1,3,1,1,31,15,45,27,337,113,987,
+ 2065,2529,8351,1,1,5,9,5,15,105,123,479,289,1609,2177,4629,8357,1,3,5,11,31,
+ 47,97,87,385,195,1041,651,3271,8367,1,1,3,7,17,3,101,55,87,629,1687,1387,
+ 2745,8379,1,3,5,5,7,21,9,237,313,549,1107,117,6183,8381,1,1,3,9,9,5,55,201,
+ 487,851,1103,2993,4055,8387,1,1,5,9,31,19,59,7,363,381,1167,2057,5715,8393,1,
+ 3,3,15,23,63,19,227,387,827,487,1049,7471,8417,1,3,1,5,23,25,61,245,363,863,
+ 963,3583,6475,8435,1,1,5,1,5,27,81,85,275,49,235,3291,1195,8461,1,1,5,7,23,
+ 53,85,107,511,779,1265,1093,7859,8469,1,3,3,1,9,21,75,219,59,485,1739,3845,
+ 1109,8489,1,3,5,1,13,41,19,143,293,391,2023,1791,4399,8495,1,3,7,15,21,13,21,
+ 195,215,413,523,2099,2341,8507,1,1,1,3,29,51,47,57,135,575,943,1673,541,8515,
+ 1,3,5,1,9,13,113,175,447,115,657,4077,5973,8551,1,1,1,11,17,41,37,95,297,579,
+ 911,2207,2387,8555,1,3,5,3,23,11,23,231,93,667,711,1563,7961,8569,1,1,7,3,17,
+ 59,13,181,141,991,1817,457,1711,8585,1,3,3,5,31,59,81,205,245,537,1049,997,
+ 1815,8599,1,3,7,5,17,13,9,79,17,185,5,2211,6263,8605,1,3,7,13,7,53,61,145,13,
+ 285,1203,947,2933,8639,1,1,7,3,31,19,69,217,47,441,1893,673,4451,8641,1,1,1,
+ 1,25,9,23,225,385,629,603,3747,4241,8647,1,3,1,9,5,37,31,237,431,79,1521,459,
+ 2523,8653,1,3,7,3,9,43,105,179,5,225,799,1777,4893,8671,1,1,3,1,29,45,29,159,
+ 267,247,455,847,3909,8675,1,1,3,7,25,21,121,57,467,275,719,1521,7319,8689,1,
+ 3,1,3,11,35,119,123,81,979,1187,3623,4293,8699,1,1,1,7,15,25,121,235,25,487,
+ 873,1787,1977,8729,1,1,1,11,3,7,17,135,345,353,383,4011,2573,8741,1,3,7,15,
+ 27,13,97,123,65,675,951,1285,6559,8759,1,3,7,3,7,1,71,19,325,765,337,1197,
+ 2697,8765,1,3,5,1,31,37,11,71,169,283,83,3801,7083,8771,1,1,3,15,17,29,83,65,
+ 275,679,1749,4007,7749,8795,1,1,3,1,21,11,41,95,237,361,1819,2783,2383,8797,
+ 1,3,7,11,29,57,111,187,465,145,605,1987,8109,8825,1,1,3,3,19,15,55,83,357,
+ 1001,643,1517,6529,8831,1,3,1,5,29,35,73,23,77,619,1523,1725,8145,8841,1,1,5,
+ 5,19,23,7,197,449,337,717,2921,315,8855,1,3,5,9,7,63,117,97,97,813,1925,2817,
+ 1579,8859,1,1,1,11,31,7,25,235,231,133,1007,1371,1553,8883,1,1,7,5,19,7,47,
+ 171,267,243,1331,567,6033,8895,1,1,5,1,7,49,55,89,109,735,1455,3193,6239,
+ 8909,1,1,1,7,1,61,9,103,3,929,1481,2927,2957,8943,1,1,5,13,17,21,75,49,255,
+ 1019,1161,2133,1177,8951,1,3,1,3,13,15,41,247,211,409,1163,523,2635,8955,1,3,
+ 7,7,21,59,91,149,479,391,681,2311,6249,8965,1,1,5,11,27,53,21,211,197,815,
+ 719,1605,255,8999,1,1,3,3,9,33,59,3,323,1,101,1135,8105,9003,1,3,3,1,29,5,17,
+ 141,51,991,841,327,3859,9031,1,3,1,5,11,19,23,89,175,173,165,2881,1881,9045,
+ 1,1,1,15,13,51,87,39,495,611,1341,1531,7029,9049,1,1,3,11,13,55,75,185,57,61,
+ 1917,2051,5965,9071,1,1,5,5,7,53,11,217,213,933,921,3607,5175,9073,1,3,3,5,
+ 17,53,103,251,369,781,1319,3717,4439,9085,1,3,5,13,1,39,25,235,321,773,251,
+ 3111,6397,9095,1,1,7,3,31,5,25,29,325,385,1313,127,4705,9101,1,1,5,15,15,27,
+ 15,85,239,243,1633,3473,2621,9109,1,3,3,3,9,19,113,13,137,165,25,2957,7549,
+ 9123,1,3,1,3,11,21,3,97,417,183,1205,1437,247,9129,1,1,7,3,17,21,125,55,67,
+ 387,385,2323,887,9137,1,3,5,5,29,11,103,223,233,641,133,415,1297,9143,1,3,3,
+ 11,1,9,5,189,235,1007,1363,3985,889,9147,1,3,7,9,23,19,19,183,269,403,1643,
+ 3559,5189,9185,1,3,7,3,29,45,17,69,475,149,1291,2689,7625,9197,1,3,7,3,27,37,
+ 41,73,253,1001,431,1111,7887,9209,1,1,7,5,3,7,87,143,289,495,631,3011,6151,
+ 9227,1,1,1,13,5,45,17,167,23,975,801,1975,6833,9235,1,3,1,11,7,21,39,23,213,
+ 429,1301,2059,197,9247,1,3,3,15,3,57,121,133,29,711,1961,2497,189,9253,1,1,3,
+ 5,11,55,115,137,233,673,985,2849,5911,9257,1,1,7,15,29,45,1,241,329,323,925,
+ 2821,3331,9277,1,1,5,7,13,31,81,105,199,145,195,1365,5119,9297,1,3,7,11,3,55,
+ 11,31,117,343,1265,1837,2451,9303,1,1,3,7,29,57,61,179,429,591,177,1945,2159,
+ 9313,1,3,5,11,23,49,101,137,339,323,1035,1749,7737,9325,1,3,1,13,21,35,55,79,
+ 19,269,1055,2651,7083,9343,1,3,3,11,9,9,95,167,437,361,1185,4083,603,9347,1,
+ 1,1,7,31,61,77,65,489,657,691,2423,4147,9371,1,3,5,7,21,37,87,191,311,453,
+ 2013,829,2619,9373,1,1,5,9,17,47,35,101,5,813,1157,1279,7365,9397,1,1,5,3,11,
+ 35,113,199,369,721,901,1471,7801,9407,1,3,1,5,9,61,83,157,391,739,1957,2123,
+ 4341,9409,1,3,5,11,19,19,111,225,383,219,997,717,7505,9415,1,3,1,11,13,63,35,
+ 127,209,831,501,3017,3507,9419,1,3,7,9,29,7,11,163,81,563,1445,3215,6377,
+ 9443,1,3,7,11,25,3,39,195,491,45,839,4021,4899,9481,1,3,7,15,13,5,67,143,117,
+ 505,1281,3679,5695,9495,1,3,7,9,9,19,21,221,147,763,683,2211,589,9501,1,1,3,
+ 5,21,47,53,109,299,807,1153,1209,7961,9505,1,3,7,11,9,31,45,43,505,647,1127,
+ 2681,4917,9517,1,1,5,15,31,41,63,113,399,727,673,2587,5259,9529,1,1,1,13,17,
+ 53,35,99,57,243,1447,1919,2831,9555,1,3,7,11,23,51,13,9,49,449,997,3073,4407,
+ 9557,1,3,5,7,23,33,89,41,415,53,697,1113,1489,9571,1,1,3,7,1,13,29,13,255,
+ 749,77,3463,1761,9585,1,3,3,7,13,15,93,191,309,869,739,1041,3053,9591,1,3,5,
+ 13,5,19,109,211,347,839,893,2947,7735,9607,1,3,1,13,27,3,119,157,485,99,1703,
+ 3895,573,9611,1,3,7,11,1,23,123,105,31,359,275,1775,3685,9621,1,3,3,5,27,11,
+ 125,3,413,199,2043,2895,2945,9625,1,3,3,3,15,49,121,159,233,543,193,4007,321,
+ 9631,1,1,3,5,9,47,87,1,51,1011,1595,2239,6467,9647,1,3,7,9,1,33,87,137,469,
+ 749,1413,805,6817,9661,1,3,1,13,19,45,95,227,29,677,1275,3395,4451,9669,1,1,
+ 7,5,7,63,33,71,443,561,1311,3069,6943,9679,1,1,1,13,9,37,23,69,13,415,1479,
+ 1197,861,9687,1,3,3,13,27,21,13,233,105,777,345,2443,1105,9707,1,1,7,11,23,
+ 13,21,147,221,549,73,2729,6279,9731,1,1,7,7,25,27,15,45,227,39,75,1191,3563,
+ 9733,1,1,5,7,13,49,99,167,227,13,353,1047,8075,9745,1,1,3,13,31,9,27,7,461,
+ 737,1559,3243,53,9773,1,3,1,1,21,41,97,165,171,821,587,2137,2293,9791,1,3,1,
+ 11,17,41,29,187,87,599,1467,1395,5931,9803,1,1,1,9,9,49,89,205,409,453,61,
+ 1923,1257,9811,1,3,7,3,9,43,89,143,431,83,1243,1795,3599,9817,1,3,5,13,3,25,
+ 59,219,43,223,797,2651,6015,9833,1,1,5,15,7,55,65,207,213,311,1287,1269,6467,
+ 9847,1,3,7,11,21,57,31,183,351,857,911,1683,7155,9851,1,3,5,11,27,1,21,47,
+ 387,383,1593,115,3805,9863,1,3,1,1,13,23,87,173,181,619,1653,3931,6073,9875,
+ 1,1,7,5,17,43,37,61,307,621,1785,55,115,9881,1,3,7,15,25,61,123,15,237,671,
+ 1473,467,1907,9905,1,1,7,5,29,57,75,237,85,699,159,3577,4771,9911,1,1,1,11,
+ 25,19,51,1,147,31,895,2617,625,9917,1,3,7,5,29,15,115,175,395,391,1141,1827,
+ 1181,9923,1,3,5,7,17,7,11,193,89,243,561,3787,4551,9963,1,3,1,11,7,57,7,125,
+ 403,947,1261,409,8083,9973,1,1,5,13,21,63,115,233,231,921,1747,3635,2519,
+ 10003,1,1,5,11,3,27,15,91,505,591,1451,3881,2997,10025,1,1,3,11,21,9,109,153,
+ 317,533,593,3967,2797,10043,1,3,3,13,9,57,121,245,219,867,967,791,7095,10063,
+ 1,1,1,9,29,21,99,35,375,959,329,4087,7171,10071,1,1,1,9,11,17,17,97,89,135,
+ 631,3809,3253,10077,1,1,1,15,21,51,91,249,459,801,757,2353,2033,10091,1,3,5,
+ 9,23,29,77,53,399,767,1817,2171,1629,10099,1,1,3,5,29,5,43,121,17,859,1479,
+ 3785,6641,10105,1,1,3,7,7,61,45,109,371,833,91,153,4553,10115,1,1,3,11,7,55,
+ 81,123,389,139,1933,891,1789,10129,1,3,7,15,25,17,93,165,503,717,1553,1475,
+ 1627,10145,1,1,1,13,13,63,13,225,357,571,33,4073,3795,10169,1,1,3,11,1,31,
+ 107,145,407,961,501,2987,103,10183,1,1,7,1,23,63,49,193,173,281,25,2465,5927,
+ 10187,1,1,7,1,1,1,85,77,273,693,349,1239,4503,10207,1,1,5,11,7,61,9,121,25,
+ 357,1443,405,7827,10223,1,1,7,13,11,53,11,207,145,211,1703,1081,2117,10225,1,
+ 1,3,11,27,23,19,9,297,279,1481,2273,6387,10247,1,3,3,5,15,45,3,41,305,87,
+ 1815,3461,5349,10265,1,3,3,13,9,37,79,125,259,561,1087,4091,793,10271,1,3,5,
+ 7,31,55,7,145,347,929,589,2783,5905,10275,1,1,7,15,3,25,1,181,13,243,653,
+ 2235,7445,10289,1,3,5,5,17,53,65,7,33,583,1363,1313,2319,10299,1,3,3,7,27,47,
+ 97,201,187,321,63,1515,7917,10301,1,1,3,5,23,9,3,165,61,19,1789,3783,3037,
+ 10309,1,3,1,13,15,43,125,191,67,273,1551,2227,5253,10343,1,1,1,13,25,53,107,
+ 33,299,249,1475,2233,907,10357,1,3,5,1,23,37,85,17,207,643,665,2933,5199,
+ 10373,1,1,7,7,25,57,59,41,15,751,751,1749,7053,10411,1,3,3,1,13,25,127,93,
+ 281,613,875,2223,6345,10413,1,1,5,3,29,55,79,249,43,317,533,995,1991,10431,1,
+ 3,3,15,17,49,79,31,193,233,1437,2615,819,10445,1,1,5,15,25,3,123,145,377,9,
+ 455,1191,3953,10453,1,3,5,3,15,19,41,231,81,393,3,19,2409,10463,1,1,3,1,27,
+ 43,113,179,7,853,947,2731,297,10467,1,1,1,11,29,39,53,191,443,689,529,3329,
+ 7431,10473,1,3,7,5,3,29,19,67,441,113,949,2769,4169,10491,1,3,5,11,11,55,85,
+ 169,215,815,803,2345,3967,10505,1,1,7,9,5,45,111,5,419,375,303,1725,4489,
+ 10511,1,3,5,15,29,43,79,19,23,417,381,541,4923,10513,1,1,3,15,3,31,117,39,
+ 117,305,1227,1223,143,10523,1,1,5,9,5,47,87,239,181,353,1561,3313,1921,10539,
+ 1,3,3,1,3,15,53,221,441,987,1997,2529,8059,10549,1,1,7,11,15,57,111,139,137,
+ 883,1881,2823,5661,10559,1,3,5,5,21,11,5,13,27,973,587,1331,1373,10561,1,1,7,
+ 11,29,51,93,29,217,221,55,2477,1979,10571,1,3,3,13,3,11,49,75,379,371,1441,
+ 793,7633,10581,1,1,1,13,19,45,89,249,91,649,1695,915,5619,10615,1,3,1,7,7,29,
+ 1,77,313,895,519,771,295,10621,1,3,1,15,5,3,1,57,331,109,485,2853,6831,10625,
+ 1,1,1,15,17,3,35,99,245,971,839,2509,2803,10643,1,3,3,3,9,37,57,251,325,317,
+ 529,1313,6379,10655,1,1,1,15,25,59,1,119,95,15,795,2375,6463,10671,1,3,1,5,1,
+ 49,117,21,47,179,863,85,1669,10679,1,3,7,3,9,37,19,221,455,973,571,1427,817,
+ 10685,1,1,1,15,17,9,67,213,127,887,1299,2913,7451,10691,1,3,1,13,27,27,41,43,
+ 171,623,691,391,4885,10711,1,3,1,13,17,17,123,239,143,227,1151,519,6543,
+ 10739,1,3,7,5,7,63,97,39,101,555,1057,381,7891,10741,1,3,5,1,3,27,85,129,161,
+ 875,1945,3541,695,10755,1,3,3,5,21,59,25,183,35,25,987,1459,181,10767,1,3,5,
+ 13,1,15,127,237,349,337,1491,2383,7811,10781,1,3,5,5,31,5,109,51,409,733,
+ 1395,3207,6049,10785,1,1,5,7,13,35,113,25,263,389,299,2521,1783,10803,1,3,7,
+ 11,15,47,97,73,55,75,113,2695,1023,10805,1,3,1,1,3,13,69,211,289,483,1335,
+ 787,677,10829,1,1,3,3,17,7,37,77,505,137,1113,345,2975,10857,1,1,1,13,3,11,
+ 95,199,453,109,479,3725,239,10863,1,1,7,15,19,53,3,145,359,863,347,3833,3043,
+ 10865,1,1,7,15,25,63,127,129,125,195,155,2211,8153,10875,1,1,7,13,9,49,121,
+ 115,73,119,1851,727,47,10877,1,3,3,13,13,11,71,7,45,591,133,2407,5563,10917,
+ 1,1,1,13,23,29,87,89,501,71,1759,1119,687,10921,1,1,7,7,13,7,13,183,53,951,
+ 1877,3991,6771,10929,1,3,7,11,7,1,27,47,61,21,919,961,1091,10949,1,3,5,5,1,
+ 27,1,5,63,157,1297,1049,5893,10967,1,3,7,9,19,33,17,133,425,797,1721,153,119,
+ 10971,1,3,3,7,13,37,1,215,509,1003,61,2353,7511,10987,1,1,7,1,29,19,31,79,
+ 199,555,1209,1603,6089,10995,1,3,1,1,5,31,111,127,333,429,1863,3925,5411,
+ 11009,1,1,7,5,5,5,123,191,47,993,269,4051,2111,11029,1,1,5,15,1,9,87,5,47,
+ 463,865,1813,7357,11043,1,3,1,3,23,63,123,83,511,777,63,1285,4537,11045,1,3,
+ 3,7,27,25,31,65,441,529,1815,1893,323,11055,1,3,7,5,11,19,7,5,397,811,755,
+ 2883,4217,11063,1,3,1,13,9,21,13,7,271,539,1769,3243,5325,11075,1,1,7,1,31,
+ 13,47,131,181,457,1559,2663,6653,11081,1,3,3,7,29,55,25,203,419,91,437,1159,
+ 5691,11117,1,1,3,13,29,19,71,217,337,329,501,939,2205,11135,1,1,3,1,1,27,17,
+ 201,97,285,1269,4043,2207,11141,1,1,1,1,3,41,13,199,141,129,1515,3129,5969,
+ 11159,1,3,3,9,3,17,119,41,271,933,877,701,2197,11163,1,1,1,7,15,47,3,195,115,
+ 821,725,843,6071,11181,1,3,5,15,17,33,85,65,297,571,1123,2743,5727,11187,1,1,
+ 5,11,27,15,37,235,415,293,1439,2739,4171,11225,1,3,7,7,1,55,71,35,307,11,401,
+ 1881,933,11237,1,3,1,11,21,37,3,177,119,339,559,3991,3437,11261,1,3,3,9,17,
+ 17,97,119,301,169,157,3267,2261,11279,1,3,3,9,29,3,111,101,355,869,375,2609,
+ 7377,11297,1,3,5,9,7,21,123,99,343,693,1927,1605,4923,11307,1,1,3,5,13,31,99,
+ 17,75,385,1539,1553,7077,11309,1,3,3,5,31,35,107,11,407,1019,1317,3593,7203,
+ 11327,1,3,3,13,17,33,99,245,401,957,157,1949,1571,11329,1,3,1,11,27,15,11,
+ 109,429,307,1911,2701,861,11341,1,1,5,13,13,35,55,255,311,957,1803,2673,5195,
+ 11377,1,1,1,11,19,3,89,37,211,783,1355,3567,7135,11403,1,1,5,5,21,49,79,17,
+ 509,331,183,3831,855,11405,1,3,7,5,29,19,85,109,105,523,845,3385,7477,11413,
+ 1,1,1,7,25,17,125,131,53,757,253,2989,2939,11427,1,3,3,9,19,23,105,39,351,
+ 677,211,401,8103,11439,1,3,5,1,5,11,17,3,405,469,1569,2865,3133,11453,1,1,3,
+ 13,15,5,117,179,139,145,477,1137,2537,11461,1,1,7,9,5,21,9,93,211,963,1207,
+ 3343,4911,11473,1,1,1,9,13,43,17,53,81,793,1571,2523,3683,11479,1,3,3,13,25,
+ 21,5,59,489,987,1941,171,6009,11489,1,3,3,7,1,39,89,171,403,467,1767,3423,
+ 2791,11495,1,1,3,9,19,49,91,125,163,1013,89,2849,6785,11499,1,1,5,9,9,11,15,
+ 241,43,297,1719,1541,1821,11533,1,3,7,15,29,23,103,239,191,33,1043,3649,6579,
+ 11545,1,3,3,9,21,51,123,55,223,645,1463,4021,5891,11561,1,1,5,7,3,41,27,235,
+ 391,303,2021,3187,7607,11567,1,1,1,9,5,49,49,29,377,251,1887,1017,1301,11575,
+ 1,1,3,3,13,41,27,47,223,23,517,3227,6731,11579,1,1,7,1,31,25,47,9,511,623,
+ 2047,1263,1511,11589,1,1,3,15,15,23,53,1,261,595,85,241,7047,11611,1,3,3,11,
+ 17,5,81,73,149,781,2035,3163,4247,11623,1,3,7,7,29,59,49,79,397,901,1105,
+ 2191,6277,11637,1,3,3,11,13,27,25,173,107,73,1265,585,5251,11657,1,1,7,15,29,
+ 23,73,229,235,887,1469,4073,2591,11663,1,1,3,9,17,15,83,173,207,879,1701,
+ 1509,11,11687,1,1,3,5,5,37,65,161,39,421,1153,2007,5355,11691,1,1,7,11,23,37,
+ 5,11,9,499,17,157,5747,11701,1,3,7,13,25,9,49,7,39,945,1349,1759,1441,11747,
+ 1,1,5,3,21,15,113,81,265,837,333,3625,6133,11761,1,3,1,11,13,27,73,109,297,
+ 327,299,3253,6957,11773,1,1,3,13,19,39,123,73,65,5,1061,2187,5055,11783,1,1,
+ 3,1,11,31,21,115,453,857,711,495,549,11795,1,3,7,7,15,29,79,103,47,713,1735,
+ 3121,6321,11797,1,1,5,5,29,9,97,33,471,705,329,1501,1349,11817,1,3,3,1,21,9,
+ 111,209,71,47,491,2143,1797,11849,1,3,3,3,11,39,21,135,445,259,607,3811,5449,
+ 11855,1,1,7,9,11,25,113,251,395,317,317,91,1979,11867,1,3,1,9,3,21,103,133,
+ 389,943,1235,1749,7063,11869,1,1,3,7,1,11,5,15,497,477,479,3079,6969,11873,1,
+ 1,3,3,15,39,105,131,475,465,181,865,3813,11883,1,1,7,9,19,63,123,131,415,525,
+ 457,2471,3135,11919,1,3,7,15,25,35,123,45,341,805,485,4049,7065,11921,1,1,1,
+ 5,29,9,47,227,51,867,1873,1593,2271,11927,1,1,7,15,31,9,71,117,285,711,837,
+ 1435,6275,11933,1,3,1,1,5,19,79,25,301,415,1871,645,3251,11947,1,3,1,3,17,51,
+ 99,185,447,43,523,219,429,11955,1,3,1,13,29,13,51,93,7,995,757,3017,6865,
+ 11961,1,1,3,15,7,25,75,17,155,981,1231,1229,1995,11999,1,3,5,3,27,45,71,73,
+ 225,763,377,1139,2863,12027,1,1,3,1,1,39,69,113,29,371,1051,793,3749,12029,1,
+ 1,3,13,23,61,27,183,307,431,1345,2757,4031,12037,1,3,7,5,5,59,117,197,303,
+ 721,877,723,1601,12041,1,3,5,1,27,33,99,237,485,711,665,3077,5105,12049,1,1,
+ 3,1,13,9,103,201,23,951,2029,165,2093,12055,1,3,5,13,5,29,55,85,221,677,611,
+ 3613,4567,12095,1,1,1,1,7,61,9,233,261,561,953,4023,2443,12097,1,3,3,13,1,17,
+ 103,71,223,213,833,1747,6999,12107,1,3,5,15,25,53,57,187,25,695,1207,4089,
+ 2877,12109,1,1,7,1,7,31,87,129,493,519,1555,1155,4637,12121,1,1,1,15,21,17,
+ 23,29,19,255,927,1791,3093,12127,1,1,3,9,17,33,95,129,175,461,287,2633,2325,
+ 12133,1,3,5,7,23,19,63,209,249,583,1373,2039,2225,12137,1,3,3,5,5,19,79,241,
+ 459,355,1455,3313,3639,12181,1,1,7,9,21,41,97,119,129,769,1541,3495,7741,
+ 12197,1,1,7,11,9,29,35,255,141,937,1763,41,1393,12207,1,3,7,1,13,51,61,157,
+ 177,847,1829,3539,285,12209,1,1,1,15,21,13,9,55,397,19,1495,1255,7235,12239,
+ 1,1,7,7,25,37,53,237,319,197,269,1205,1485,12253,1,1,5,15,23,17,35,247,323,
+ 807,233,3681,4407,12263,1,1,3,7,9,59,85,105,493,763,1639,391,1451,12269,1,3,
+ 3,9,15,33,5,253,129,625,1527,2793,6057,12277,1,3,1,1,7,47,21,161,235,83,397,
+ 3563,5953,12287,1,3,7,11,3,41,25,117,375,779,1297,3715,8117,12295,1,1,3,7,31,
+ 19,103,173,475,189,2035,2921,1107,12309,1,1,7,3,25,7,93,255,307,113,1893,
+ 2233,6919,12313,1,3,5,15,9,57,79,143,165,5,1389,193,693,12335,1,3,5,1,29,45,
+ 91,49,189,461,439,1283,7835,12361,1,1,3,13,11,61,41,231,373,695,395,915,5393,
+ 12367,1,3,7,11,5,51,67,53,483,95,1943,247,5653,12391,1,3,7,5,5,57,45,235,137,
+ 793,1069,1661,1557,12409,1,3,5,3,25,55,103,177,81,861,1151,143,7655,12415,1,
+ 1,3,1,21,41,67,131,253,431,1269,3181,3429,12433,1,3,1,1,21,7,77,221,257,663,
+ 71,2949,2481,12449,1,3,5,3,3,23,45,107,299,739,1013,3,3165,12469,1,1,5,1,3,
+ 37,109,37,243,983,1221,1691,3869,12479,1,1,5,5,31,7,5,193,397,867,1495,3435,
+ 7441,12481,1,1,1,1,17,59,97,233,389,597,1013,1631,483,12499,1,1,1,11,7,41,
+ 107,53,111,125,1513,1921,7647,12505,1,3,3,3,31,29,117,3,365,971,1139,2123,
+ 5913,12517,1,1,1,13,23,3,1,167,475,639,1811,3841,3081,12527,1,1,5,3,5,47,65,
+ 123,275,783,95,119,7591,12549,1,3,1,15,13,33,93,237,467,431,705,4013,4035,
+ 12559,1,3,5,1,19,7,101,231,155,737,1381,3343,2051,12597,1,1,5,9,15,49,45,163,
+ 433,765,2031,201,2589,12615,1,3,7,9,19,41,31,89,93,623,105,745,4409,12621,1,
+ 1,5,1,11,45,127,85,389,439,829,477,7965,12639,1,3,3,15,13,41,1,207,435,585,
+ 311,1725,2737,12643,1,3,3,3,13,49,21,31,197,799,1411,2959,7133,12657,1,3,1,3,
+ 7,43,9,141,133,579,1059,93,957,12667,1,3,7,1,15,51,23,213,381,851,699,2261,
+ 3419,12707,1,3,5,9,25,35,67,141,35,409,1423,365,1645,12713,1,3,3,11,15,33,27,
+ 181,93,87,1761,3511,1353,12727,1,3,5,3,25,63,111,137,321,819,705,1547,7271,
+ 12741,1,3,1,1,5,57,99,59,411,757,1371,3953,3695,12745,1,3,5,11,11,21,25,147,
+ 239,455,709,953,7175,12763,1,3,3,15,5,53,91,205,341,63,723,1565,7135,12769,1,
+ 1,7,15,11,21,99,79,63,593,2007,3629,5271,12779,1,3,3,1,9,21,45,175,453,435,
+ 1855,2649,6959,12781,1,1,3,15,15,33,121,121,251,431,1127,3305,4199,12787,1,1,
+ 1,9,31,15,71,29,345,391,1159,2809,345,12799,1,3,7,1,23,29,95,151,327,727,647,
+ 1623,2971,12809,1,1,7,7,9,29,79,91,127,909,1293,1315,5315,12815,1,1,5,11,13,
+ 37,89,73,149,477,1909,3343,525,12829,1,3,5,7,5,59,55,255,223,459,2027,237,
+ 4205,12839,1,1,1,7,27,11,95,65,325,835,907,3801,3787,12857,1,1,1,11,27,33,99,
+ 175,51,913,331,1851,4133,12875,1,3,5,5,13,37,31,99,273,409,1827,3845,5491,
+ 12883,1,1,3,7,23,19,107,85,283,523,509,451,421,12889,1,3,5,7,13,9,51,81,87,
+ 619,61,2803,5271,12901,1,1,1,15,9,45,35,219,401,271,953,649,6847,12929,1,1,7,
+ 11,9,45,17,219,169,837,1483,1605,2901,12947,1,1,7,7,21,43,37,33,291,359,71,
+ 2899,7037,12953,1,3,3,13,31,53,37,15,149,949,551,3445,5455,12959,1,3,1,5,19,
+ 45,81,223,193,439,2047,3879,789,12969,1,1,7,3,11,63,35,61,255,563,459,2991,
+ 3359,12983,1,1,5,9,13,49,47,185,239,221,1533,3635,2045,12987,1,3,7,3,25,37,
+ 127,223,51,357,483,3837,6873,12995,1,1,7,9,31,37,113,31,387,833,1243,1543,
+ 5535,13015,1,3,1,9,23,59,119,221,73,185,2007,2885,2563,13019,1,1,1,13,7,33,
+ 53,179,67,185,1541,1807,4659,13031,1,3,1,11,31,37,23,215,269,357,207,645,
+ 4219,13063,1,3,3,13,19,27,107,55,91,71,1695,1815,89,13077,1,1,3,15,3,19,35,
+ 247,49,529,1523,3317,6151,13103,1,1,7,7,23,25,107,139,483,503,1277,243,7879,
+ 13137,1,3,3,13,3,15,11,197,135,839,985,275,5527,13149,1,3,5,3,25,47,95,21,
+ 113,307,1001,3065,295,13173,1,1,3,9,19,19,99,213,363,449,735,2851,2521,13207,
+ 1,1,3,9,5,49,63,61,157,857,497,2801,6987,13211,1,1,1,9,1,41,109,119,499,939,
+ 867,3675,8023,13227,1,3,1,1,13,33,109,123,289,3,1271,2773,4265,13241,1,3,1,
+ 11,9,57,83,221,95,43,1189,457,7133,13249,1,1,7,3,11,49,33,219,229,289,685,
+ 3359,4495,13255,1,3,1,3,19,43,67,193,41,771,407,81,3891,13269,1,1,7,11,5,29,
+ 51,175,297,539,1,2245,6439,13283,1,3,7,15,21,33,117,183,511,489,1283,3281,
+ 5979,13285,1,3,7,5,9,3,125,147,359,549,369,3049,2405,13303,1,3,5,7,19,5,65,
+ 97,483,377,1523,1457,2995,13307,1,1,5,1,11,21,41,113,277,131,1475,1043,2367,
+ 13321,1,3,3,1,15,17,101,69,443,865,817,1421,5231,13339,1,1,3,3,3,55,95,99,75,
+ 195,1929,3931,5855,13351,1,3,1,3,19,23,93,213,241,551,1307,585,7729,13377,1,
+ 3,1,11,23,15,53,249,467,519,95,741,409,13389,1,1,1,15,29,37,43,203,233,877,
+ 77,1933,2729,13407,1,3,7,11,27,39,43,161,255,15,1463,833,495,13417,1,1,7,11,
+ 3,53,81,67,375,823,1903,3061,395,13431,1,1,1,1,15,37,93,233,247,501,1321,
+ 3275,5409,13435,1,3,3,7,7,11,5,105,139,983,1239,531,3881,13447,1,1,5,3,19,49,
+ 107,227,361,101,355,2649,7383,13459,1,1,7,5,25,41,101,121,209,293,1937,2259,
+ 5557,13465,1,1,3,7,7,1,9,13,463,1019,995,3159,107,13477,1,3,5,11,5,35,127,97,
+ 261,789,807,807,6257,13501,1,1,7,5,11,13,45,91,417,101,1973,3645,2107,13513,
+ 1,1,3,7,5,63,57,49,203,157,115,1393,8117,13531,1,3,5,5,3,43,15,155,127,489,
+ 1165,3701,4867,13543,1,1,7,7,29,29,69,215,415,367,371,1901,6075,13561,1,1,1,
+ 3,11,33,89,149,433,705,1437,1597,505,13581,1,3,5,1,13,37,19,119,5,581,2037,
+ 1633,2099,13599,1,3,7,13,5,49,103,245,215,515,133,2007,1933,13605,1,3,1,9,1,
+ 3,25,197,253,387,1683,2267,221,13617,1,3,5,15,21,9,73,201,405,999,437,3877,
+ 6045,13623,1,1,3,1,31,55,25,83,421,395,1807,2129,7797,13637,1,1,3,1,23,21,
+ 121,183,125,347,143,3685,4317,13647,1,3,3,3,17,45,17,223,267,795,1815,1309,
+ 155,13661,1,1,1,15,17,59,5,133,15,715,1503,153,2887,13677,1,1,1,1,27,13,119,
+ 77,243,995,1851,3719,4695,13683,1,3,1,5,31,49,43,165,49,609,1265,1141,505,
+ 13695,1,1,7,13,11,63,21,253,229,585,1543,3719,4141,13725,1,3,7,11,23,27,17,
+ 131,295,895,1493,1411,3247,13729,1,1,5,9,29,7,97,15,113,445,859,1483,1121,
+ 13753,1,3,1,9,13,49,99,107,323,201,681,3071,5281,13773,1,1,1,15,9,19,61,161,
+ 7,87,587,2199,2811,13781,1,3,3,15,15,19,95,45,299,829,981,3479,487,13785,1,1,
+ 1,9,3,37,7,19,227,13,397,513,1257,13795,1,1,5,15,15,13,17,111,135,929,1145,
+ 811,1801,13801,1,3,1,3,27,57,31,19,279,103,693,631,3409,13807,1,1,1,1,15,13,
+ 67,83,23,799,1735,2063,3363,13825,1,3,3,7,3,1,61,31,41,533,2025,4067,6963,
+ 13835,1,1,5,7,17,27,81,79,107,205,29,97,4883,13855,1,1,1,5,19,49,91,201,283,
+ 949,651,3819,5073,13861,1,1,7,9,11,13,73,197,37,219,1931,3369,6017,13871,1,1,
+ 7,15,11,7,75,205,7,819,399,661,6487,13883,1,3,3,3,27,37,95,41,307,165,1077,
+ 3485,563,13897,1,3,5,3,21,49,57,179,109,627,1789,431,2941,13905,1,1,7,5,11,
+ 19,43,137,149,679,1543,245,1381,13915,1,3,5,5,15,3,69,81,135,159,1363,3401,
+ 6355,13939,1,3,5,1,9,61,49,53,319,25,1647,1297,615,13941,1,3,5,11,31,43,9,
+ 101,71,919,335,3147,5823,13969,1,3,1,1,15,5,29,109,511,945,867,3677,6915,
+ 13979,1,3,3,15,17,49,91,111,215,29,1879,97,2505,13981,1,3,1,13,19,61,11,111,
+ 163,777,533,1113,5339,13997,1,1,7,9,17,55,117,91,455,289,557,913,4455,14027,
+ 1,3,1,7,25,19,123,37,1,277,717,2965,4469,14035,1,3,7,3,19,23,87,235,209,457,
+ 2041,2893,1805,14037,1,3,3,5,5,43,23,61,351,791,59,2009,2909,14051,1,1,3,7,5,
+ 1,27,231,385,257,1261,2701,1807,14063,1,3,1,1,27,19,87,253,131,685,1743,3983,
+ 2651,14085,1,3,7,11,21,17,11,81,191,641,1821,3005,7251,14095,1,3,3,5,15,31,
+ 41,213,55,931,1953,49,6037,14107,1,1,7,15,7,27,65,223,113,79,1875,911,5445,
+ 14113,1,3,7,7,23,55,51,167,495,25,1585,3447,799,14125,1,1,3,7,27,15,95,193,
+ 337,415,975,3085,967,14137,1,1,7,15,19,7,93,41,433,551,401,3169,3971,14145,1,
+ 1,7,11,13,15,53,69,433,59,1117,3359,6231,14151,1,1,7,3,23,5,115,201,225,109,
+ 1903,3897,6265,14163,1,1,1,11,17,1,39,143,361,659,1105,23,4923,14193,1,1,1,9,
+ 27,57,85,227,261,119,1881,3965,6999,14199,1,3,7,7,15,7,107,17,315,49,1591,
+ 905,7789,14219,1,3,1,7,29,3,47,237,157,769,839,3199,3195,14229,1,1,3,15,25,
+ 39,63,15,111,857,881,1505,7671,14233,1,1,7,1,3,35,41,215,99,895,1025,1483,
+ 4707,14243,1,3,5,1,1,31,25,247,113,841,397,1825,6969,14277,1,1,3,5,19,41,49,
+ 243,225,973,241,175,1041,14287,1,1,1,7,15,15,105,141,83,75,1675,3523,5219,
+ 14289,1,1,7,5,13,27,47,199,445,841,959,1157,2209,14295,1,3,5,15,23,31,31,81,
+ 85,33,785,2639,7799,14301,1,1,5,13,21,3,47,99,235,943,1731,2467,7891,14305,1,
+ 1,1,3,17,53,85,219,73,131,1339,875,1191,14323,1,1,5,7,17,63,113,7,185,557,
+ 749,3563,4973,14339,1,3,3,15,15,21,43,111,155,689,345,423,3597,14341,1,1,5,1,
+ 15,29,93,5,361,713,695,3937,425,14359,1,3,7,7,13,41,115,175,315,937,123,2841,
+ 4457,14365,1,1,3,11,25,5,103,53,423,811,657,399,7257,14375,1,1,1,1,1,13,101,
+ 211,383,325,97,1703,4429,14387,1,3,7,9,31,45,83,157,509,701,841,1105,3643,
+ 14411,1,1,1,7,1,9,69,17,129,281,1161,2945,7693,14425,1,3,7,1,11,29,51,143,77,
+ 433,1723,2317,5641,14441,1,1,1,1,21,43,13,67,177,505,1629,1267,4885,14449,1,
+ 1,3,11,27,63,111,47,233,781,453,1679,3209,14499,1,1,3,13,29,27,119,141,493,
+ 971,461,1159,633,14513,1,1,3,15,23,5,79,215,163,149,1805,2399,61,14523,1,3,5,
+ 13,19,5,1,39,409,561,709,829,1357,14537,1,3,3,13,19,43,9,177,449,447,73,2107,
+ 5669,14543,1,3,5,1,23,13,63,109,203,593,829,4017,6881,14561,1,1,5,7,3,9,53,
+ 175,391,169,1283,3793,4451,14579,1,1,5,7,29,43,9,5,209,77,927,2941,8145,
+ 14585,1,3,5,15,17,49,5,143,131,771,1685,925,2175,14593,1,1,3,11,27,27,27,159,
+ 161,1015,1587,4049,1983,14599,1,3,1,3,23,57,119,67,481,577,389,3319,5325,
+ 14603,1,3,5,1,19,39,87,61,329,657,1773,31,1707,14611,1,1,3,1,5,25,15,241,131,
+ 815,1751,3029,8039,14641,1,3,3,13,27,13,77,87,437,57,621,1031,7891,14671,1,3,
+ 1,13,23,51,117,37,331,745,605,3179,4713,14695,1,1,5,5,19,17,99,167,87,721,
+ 737,789,2165,14701,1,3,5,13,1,51,119,211,165,299,1327,3053,3343,14723,1,1,5,
+ 15,29,45,17,129,67,345,1553,2705,7369,14725,1,1,1,9,23,7,13,209,7,407,317,
+ 3077,7287,14743,1,1,1,5,9,59,89,3,487,451,505,2499,7563,14753,1,3,1,7,21,1,
+ 21,203,101,417,1389,2751,1397,14759,1,3,7,13,7,31,3,247,349,485,1259,549,
+ 6321,14765,1,1,7,7,27,33,107,197,293,729,1753,2571,103,14795,1,3,5,9,25,35,5,
+ 253,137,213,2041,3387,1809,14797,1,1,7,13,15,35,67,83,295,175,839,2831,839,
+ 14803,1,3,3,11,3,17,55,141,247,991,117,3799,1221,14831,1,1,5,1,11,37,87,233,
+ 457,653,899,2933,3105,14839,1,1,3,15,3,31,67,167,437,9,651,1109,1139,14845,1,
+ 1,3,1,7,63,67,17,11,883,1855,1941,4751,14855,1,3,7,9,19,33,113,117,495,39,
+ 1795,2561,5519,14889,1,1,7,5,1,3,103,37,201,223,1101,877,6483,14895,1,1,5,9,
+ 29,49,51,33,439,917,861,1321,2135,14909,1,1,3,3,1,5,17,93,217,619,613,1357,
+ 6095,14929,1,3,1,11,3,21,5,41,15,175,843,2937,6849,14941,1,3,3,7,9,57,55,127,
+ 79,287,445,2205,7989,14945,1,1,7,13,23,17,93,129,157,135,1747,1813,4183,
+ 14951,1,1,1,5,31,59,99,33,425,329,887,367,1761,14963,1,1,7,9,17,53,77,139,
+ 435,387,49,3649,1773,14965,1,3,3,15,21,57,45,161,331,719,273,3479,4173,14985,
+ 1,1,3,9,3,3,105,201,373,877,919,1263,6649
+};
+
+/************************************/
+/* Release the tables of a sequence */
+/************************************/
+static void qs_clear(s_qmcseq *qs)
+{
+ free(qs->v);
+ qs->v=qs->x=NULL;
+ qs->dim=0;
+ qs->n=0;
+}
+
+/******************************************************/
+/* Allocate the tables for dimension d (0 if failure) */
+/******************************************************/
+static int qs_alloc(XPRMcontext ctx,s_qmcseq *qs,int d)
+{
+ qs->v=malloc(d*33*sizeof(unsigned int));
+ if(qs->v==NULL)
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return 0;
+ }
+ else
+ {
+  qs->x=qs->v+32*d;
+  qs->dim=d;
+  qs->n=0;
+  return 1;
+ }
+}
+
+/*************************************/
+/* Create a low-discrepancy sequence */
+/*************************************/
+static void *qs_create(XPRMcontext ctx,void *libctx,void *todup,int typnum)
+{
+ s_qmcseq *qs;
+
+ if(todup!=NULL)
+ {
+  ((s_qmcseq *)todup)->refcnt++;
+  return todup;
+ }
+ else
+ {
+  qs=malloc(sizeof(s_qmcseq));
+  if(qs==NULL)
+   mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  else
+  {
+   memset(qs,0,sizeof(s_qmcseq));
+   qs->refcnt=1;
+  }
+  return qs;
+ }
+}
+
+/*************************************/
+/* Delete a low-discrepancy sequence */
+/*************************************/
+static void qs_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum)
+{
+ s_qmcseq *qs;
+
+ qs=todel;
+ if((qs!=NULL)&&(--qs->refcnt<1))
+ {
+  qs_clear(qs);
+  free(qs);
+ }
+}
+
+/**************************************/
+/* Low-discrepancy sequence -> String */
+/**************************************/
+static int qs_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,
+                int len,int typnum)
+{
+ s_qmcseq *qs;
+
+ qs=toprt;
+ if((qs==NULL)||(qs->dim<1))
+  return snprintf(str,len,"qmcseq(0)");
+ else
+  return snprintf(str,len,"%s(%d)",qmcnames[qs->kind],qs->dim);
+}
+
+/***************************************************/
+/* Copy a low-discrepancy sequence (tables cloned) */
+/***************************************************/
+static int qs_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,
+                int typnum)
+{
+ s_qmcseq *qd,*qsrc;
+
+ qd=toinit;
+ qsrc=src;
+ switch(XPRM_CPY(typnum))
+ {
+  case XPRM_CPY_COPY:
+  case XPRM_CPY_RESET:
+      if(qd==qsrc) return 0;
+      qs_clear(qd);
+      if((qsrc!=NULL)&&(qsrc->dim>0))
+      {
+       if(!qs_alloc(ctx,qd,qsrc->dim)) return 1;
+       memcpy(qd->v,qsrc->v,qsrc->dim*33*sizeof(unsigned int));
+       qd->kind=qsrc->kind;
+       qd->n=qsrc->n;
+      }
+      return 0;
+  default:
+      return 1;
+ }
+}
+
+/*********************************************/
+/* Direction numbers of the Sobol sequence:  */
+/* v[32*j+k] is the k-th number of dim. j+1  */
+/*********************************************/
+static void qs_sobolinit(s_qmcseq *qs)
+{
+ const unsigned short *t;
+ unsigned int *v,p;
+ int i,j,k,s;
+
+ v=qs->v;
+ for(k=0;k<32;k++)              /* First dimension: van der Corput */
+  v[k]=1U<<(31-k);
+ t=sb_tab;
+ for(j=1;j<qs->dim;j++)
+ {
+  v+=32;
+  p=*(t++);
+  for(s=0;(p>>(s+1))!=0;s++);   /* Degree of the polynomial */
+  for(k=0;k<s;k++)
+   v[k]=((unsigned int)*(t++))<<(31-k);
+  for(;k<32;k++)
+  {
+   v[k]=v[k-s]^(v[k-s]>>s);
+   for(i=1;i<s;i++)
+    if((p>>(s-i))&1)
+     v[k]^=v[k-i];
+  }
+ }
+ memset(qs->x,0,qs->dim*sizeof(unsigned int));
+}
+
+/********************************************************/
+/* Halton sequence: v[2*j] is the base of dim. j+1 and  */
+/* v[2*j+1] the multiplier applied to its digits        */
+/********************************************************/
+static void qs_haltoninit(s_rndctx *rndctx,s_qmcseq *qs)
+{
+ unsigned int b,d;
+ int j;
+
+ b=1;
+ for(j=0;j<qs->dim;j++)
+ {
+  do                            /* Next prime */
+  {
+   b++;
+   for(d=2;(d*d<=b)&&(b%d!=0);d++);
+  } while(d*d<=b);
+  qs->v[2*j]=b;
+  qs->v[2*j+1]=(b>2)?1+(unsigned int)(RANDOM*(b-1)):1;
+ }
+}
+
+/**********************************************/
+/* qmcseq(kind,d): sequence of dimension d    */
+/* (the Halton scrambling uses the generator) */
+/**********************************************/
+static int qs_new(XPRMcontext ctx,void *libctx)
+{
+ s_qmcseq *qs;
+ const char *kind;
+ int d,k;
+
+ kind=XPRM_POP_STRING(ctx);
+ d=XPRM_POP_INT(ctx);
+ for(k=0;(k<(int)QMC_NB)&&((kind==NULL)||strcmp(kind,qmcnames[k]));k++);
+ if((k>=(int)QMC_NB)||(d<1)||(d>QMC_MAXDIM))
+  return rnd_math_error(ctx,"qmcseq");
+ else
+ if((qs=qs_create(ctx,libctx,NULL,0))==NULL)
+  return XPRM_RT_ERROR;
+ else
+ if(!qs_alloc(ctx,qs,d))
+ {
+  qs_delete(ctx,libctx,qs,0);
+  return XPRM_RT_ERROR;
+ }
  else
  {
-  x=0;
-  for(;n>0;n--)
-   x+=geometric(libctx,p);
-  XPRM_TOP_ST(ctx)->integer=x;
+  qs->kind=k;
+  if(k==QMC_SOBOL)
+   qs_sobolinit(qs);
+  else
+   qs_haltoninit(libctx,qs);
+  XPRM_PUSH_REF(ctx,qs);
   return XPRM_RT_OK;
  }
 }
 
-/* =========================================================
- * Returns an exponentially distributed positive real number. 
- * NOTE: use m > 0.0
- * =========================================================
- */
-static double exponential(s_rndctx *rndctx,double m)
-{ return (-m * log(1.0 - RANDOM)); }
-
-static int rnd_exponential(XPRMcontext ctx,void *libctx)
+/******************************************************/
+/* Compute the next point (0 if sequence is finished) */
+/******************************************************/
+static int qs_next(s_qmcseq *qs,double *pt)
 {
- double m;
+ unsigned int n,b,f,r;
+ double x,s;
+ int j,c;
 
- m=XPRM_TOP_ST(ctx)->real;
- if(m<=0)
-  return rnd_math_error(ctx,"exponential");
+ if(qs->n==0xffffffffU)
+  return 0;
+ if(qs->kind==QMC_SOBOL)
+ {
+  n=qs->n;                      /* c: position of the lowest 0 bit of n */
+  for(c=0;n&1;c++,n>>=1);
+  for(j=0;j<qs->dim;j++)
+  {
+   qs->x[j]^=qs->v[32*j+c];
+   pt[j]=qs->x[j]*(1.0/4294967296.0);
+  }
+  qs->n++;
+ }
  else
  {
-  XPRM_TOP_ST(ctx)->real=exponential(libctx,m);
-  return XPRM_RT_OK;
+  qs->n++;
+  for(j=0;j<qs->dim;j++)
+  {
+   b=qs->v[2*j];
+   f=qs->v[2*j+1];
+   x=0;
+   s=1.0/b;
+   for(n=qs->n;n>0;n/=b,s/=b)   /* Scrambled radical inverse */
+   {
+    r=(unsigned int)(((unsigned long long)f*(n%b))%b);
+    x+=r*s;
+   }
+   pt[j]=x;
+  }
  }
+ return 1;
 }
 
-/* ================================================== 
- * Returns a Poisson distributed non-negative integer. 
- * NOTE: use m > 0
- * ==================================================
- */
-static int rnd_poisson(XPRMcontext ctx,void *libctx)
+/****************************************************/
+/* fillrandom(A,q): a point for each row of A where */
+/* the columns are the first dimensions of q        */
+/****************************************************/
+static int qs_fill(XPRMcontext ctx,void *libctx)
 {
- double m,t;
- int x;
+ XPRMarray arr;
+ XPRMset sets[2];
+ s_qmcseq *qs;
+ double *pt;
+ int indices[2];
+ int row,col,rts;
 
- m=XPRM_TOP_ST(ctx)->real;
- if(m<=0)
-  return rnd_math_error(ctx,"poisson");
+ arr=XPRM_POP_REF(ctx);
+ qs=XPRM_POP_REF(ctx);
+ if((qs==NULL)||(qs->dim<1))
+  return rnd_math_error(ctx,"fillrandom");
+ else
+ if((arr==NULL)||(mm->getarrsize(arr)<1))
+  return XPRM_RT_OK;
  else
+ if(mm->getarrdim(arr)!=2)
  {
-  t=0;
-  x=0;
-  while (t < m) {
-    t += exponential(libctx,1.0);
-    x++;
+  mm->dispmsg(ctx,"RANDOM: invalid array for `fillrandom'.\n");
+  return XPRM_RT_ERROR;
+ }
+
+ mm->getarrsets(arr,sets);
+ if(mm->getsetsize(sets[1])>qs->dim)
+ {
+  mm->dispmsg(ctx,"RANDOM: array has more columns than dimensions.\n");
+  return XPRM_RT_ERROR;
+ }
+ else
+ if((pt=malloc(qs->dim*sizeof(double)))==NULL)
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return XPRM_RT_ERROR;
+ }
+ else
+ {
+  rts=XPRM_RT_OK;
+  if(!mm->getfirstarrentry(arr,indices))
+  {
+   row=indices[0]-1;
+   col=0;
+   do
+   {
+    if(indices[0]!=row)
+    {
+     row=indices[0];
+     col=0;
+     if(!qs_next(qs,pt))
+     {
+      rts=rnd_math_error(ctx,"fillrandom");
+      break;
+     }
+    }
+    mm->setarrvalreal(ctx,arr,indices,pt[col++]);
+   } while(!mm->getnextarrentry(arr,indices));
   }
-  XPRM_TOP_ST(ctx)->integer=x-1;
-  return XPRM_RT_OK;
+  free(pt);
+  return rts;
  }
 }
 
-/* ================================================== 
- * Returns an Erlang distributed positive real number.
- * NOTE: use n > 0 and b > 0.0
- * ==================================================
+/******** Multivariate normal distribution ********/
+
+/* ====================================================================
+ * A 'mvnormal' is defined by a mean vector mu and a covariance matrix C
+ * (n x n). The factor F such that C=F.F' is computed once: Cholesky
+ * decomposition (F lower triangular) or, if C is only semidefinite, the
+ * eigenvalue decomposition C=V.D.V' obtained with the cyclic Jacobi
+ * method (F=V.sqrt(D)). A sample is then mu+F.z where z is a vector of
+ * n independent standard normal deviates. Samples are generated by
+ * blocks such that each row of F is used for all samples of a block
+ * while it is in cache.
+ * ====================================================================
  */
-static int rnd_erlang(XPRMcontext ctx,void *libctx)
+
+/****************************************/
+/* Release the factor of a distribution */
+/****************************************/
+static void mv_clear(s_mvnorm *mv)
 {
- int n;
- double b,x;
+ free(mv->f);
+ mv->f=mv->mu=NULL;
+ mv->n=0;
+}
 
- n=XPRM_POP_INT(ctx);
- b=XPRM_TOP_ST(ctx)->real;
- if((n<=0)||(b<=0))
-  return rnd_math_error(ctx,"erlang");
+/*************************************************/
+/* Allocate the tables for size n (0 if failure) */
+/*************************************************/
+static int mv_alloc(XPRMcontext ctx,s_mvnorm *mv,int n)
+{
+ mv->f=malloc((size_t)n*(n+1)*sizeof(double));
+ if(mv->f==NULL)
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return 0;
+ }
  else
  {
-  x=0;
-  for(;n>0;n--)
-   x+=exponential(libctx,b);
-  XPRM_TOP_ST(ctx)->real=x;
-  return XPRM_RT_OK;
+  mv->mu=mv->f+(size_t)n*n;
+  mv->n=n;
+  mv->tri=1;
+  return 1;
  }
 }
 
-/* ========================================================================
- * Returns a normal (Gaussian) distributed real number.
- * NOTE: use s > 0.0
- *
- * Uses a very accurate approximation of the normal idf due to Odeh & Evans, 
- * J. Applied Statistics, 1974, vol 23, pp 96-97.
- * ========================================================================
- */
-static double normal(s_rndctx *rndctx,double m,double s)
+/*********************************************/
+/* Create a multivariate normal distribution */
+/*********************************************/
+static void *mv_create(XPRMcontext ctx,void *libctx,void *todup,int typnum)
 {
-  const double p0 = 0.322232431088;     const double q0 = 0.099348462606;
-  const double p1 = 1.0;                const double q1 = 0.588581570495;
-  const double p2 = 0.342242088547;     const double q2 = 0.531103462366;
-  const double p3 = 0.204231210245e-1;  const double q3 = 0.103537752850;
-  const double p4 = 0.453642210148e-4;  const double q4 = 0.385607006340e-2;
-  double u, t, p, q, z;
+ s_mvnorm *mv;
 
-  u   = RANDOM;
-  if (u < 0.5)
-    t = sqrt(-2.0 * log(u));
-  else
-    t = sqrt(-2.0 * log(1.0 - u));
-  p   = p0 + t * (p1 + t * (p2 + t * (p3 + t * p4)));
-  q   = q0 + t * (q1 + t * (q2 + t * (q3 + t * q4)));
-  if (u < 0.5)
-    z = (p / q) - t;
+ if(todup!=NULL)
+ {
+  ((s_mvnorm *)todup)->refcnt++;
+  return todup;
+ }
+ else
+ {
+  mv=malloc(sizeof(s_mvnorm));
+  if(mv==NULL)
+   mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
   else
-    z = t - (p / q);
-  return (m + s * z);
+  {
+   memset(mv,0,sizeof(s_mvnorm));
+   mv->refcnt=1;
+  }
+  return mv;
+ }
 }
 
-static int rnd_normal(XPRMcontext ctx,void *libctx)
+/*********************************************/
+/* Delete a multivariate normal distribution */
+/*********************************************/
+static void mv_delete(XPRMcontext ctx,void *libctx,void *todel,int typnum)
 {
- double m,s;
+ s_mvnorm *mv;
 
- m=XPRM_POP_REAL(ctx);
- s=XPRM_TOP_ST(ctx)->real;
- if(s<=0)
-  return rnd_math_error(ctx,"normal");
- else
+ mv=todel;
+ if((mv!=NULL)&&(--mv->refcnt<1))
  {
-  XPRM_TOP_ST(ctx)->real=normal(libctx,m,s);
-  return XPRM_RT_OK;
+  mv_clear(mv);
+  free(mv);
  }
 }
 
-/* ==================================================== 
- * Returns a lognormal distributed positive real number. 
- * NOTE: use b > 0.0
- * ====================================================
- */
-static int rnd_lognormal(XPRMcontext ctx,void *libctx)
+/**********************************************/
+/* Multivariate normal distribution -> String */
+/**********************************************/
+static int mv_tostr(XPRMcontext ctx,void *libctx,void *toprt,char *str,
+                int len,int typnum)
 {
- double a,b;
+ return snprintf(str,len,"mvnormal(%d)",
+                        (toprt==NULL)?0:((s_mvnorm *)toprt)->n);
+}
 
- a=XPRM_POP_REAL(ctx);
- b=XPRM_TOP_ST(ctx)->real;
- if(b<=0)
-  return rnd_math_error(ctx,"lognormal");
- else
+/*************************************************/
+/* Copy a multivariate normal (factor is cloned) */
+/*************************************************/
+static int mv_copy(XPRMcontext ctx,void *libctx,void *toinit,void *src,
+                int typnum)
+{
+ s_mvnorm *md,*ms;
+
+ md=toinit;
+ ms=src;
+ switch(XPRM_CPY(typnum))
  {
-  XPRM_TOP_ST(ctx)->real=(exp(a + b * normal(libctx,0.0, 1.0)));
-  return XPRM_RT_OK;
+  case XPRM_CPY_COPY:
+  case XPRM_CPY_RESET:
+      if(md==ms) return 0;
+      mv_clear(md);
+      if((ms!=NULL)&&(ms->n>0))
+      {
+       if(!mv_alloc(ctx,md,ms->n)) return 1;
+       memcpy(md->f,ms->f,(size_t)ms->n*(ms->n+1)*sizeof(double));
+       md->tri=ms->tri;
+      }
+      return 0;
+  default:
+      return 1;
  }
 }
 
-/* =====================================================
- * Returns a chi-square distributed positive real number. 
- * NOTE: use n > 0
- * =====================================================
- */
-static double chisquare(s_rndctx *rndctx,int n)
+/**************************************************/
+/* Cholesky factor of c (n x n, row major) into f */
+/* Returns 0 if c is not (numerically) positive   */
+/* definite                                       */
+/**************************************************/
+static int mv_cholesky(const double *c,double *f,int n,double tol)
 {
-  long   i;
-  double z, x = 0.0;
+ double s;
+ int i,j,k;
 
-  for (i = 0; i < n; i++) {
-    z  = normal(rndctx,0.0, 1.0);
-    x += z * z;
+ memset(f,0,(size_t)n*n*sizeof(double));
+ for(j=0;j<n;j++)
+ {
+  s=c[(size_t)j*n+j];
+  for(k=0;k<j;k++)
+   s-=f[(size_t)j*n+k]*f[(size_t)j*n+k];
+  if(!(s>tol))
+   return 0;
+  f[(size_t)j*n+j]=s=sqrt(s);
+  for(i=j+1;i<n;i++)
+  {
+   double t=c[(size_t)i*n+j];
+   for(k=0;k<j;k++)
+    t-=f[(size_t)i*n+k]*f[(size_t)j*n+k];
+   f[(size_t)i*n+j]=t/s;
   }
-  return (x);
+ }
+ return 1;
 }
 
-static int rnd_chisquare(XPRMcontext ctx,void *libctx)
+/******************************************************/
+/* Factor F=V.sqrt(D) of c from its eigenvalues D and */
+/* eigenvectors V (cyclic Jacobi). c is overwritten.  */
+/* Returns 0 if c has a negative eigenvalue.          */
+/******************************************************/
+static int mv_eigen(double *c,double *f,int n)
+{
+ double off,nrm,theta,t,cs,sn,tau,aip,aiq,app,aqq,apq,lmax;
+ int p,q,i,sweep;
+
+ memset(f,0,(size_t)n*n*sizeof(double));
+ for(i=0;i<n;i++)
+  f[(size_t)i*n+i]=1;
+ nrm=0;
+ for(i=0;i<n*n;i++)
+  nrm+=c[i]*c[i];
+ for(sweep=0;sweep<100;sweep++)
+ {
+  off=0;
+  for(p=0;p<n;p++)
+   for(q=p+1;q<n;q++)
+    off+=c[(size_t)p*n+q]*c[(size_t)p*n+q];
+  if(off<=1e-30*nrm)
+   break;
+  for(p=0;p<n-1;p++)
+   for(q=p+1;q<n;q++)
+   {
+    apq=c[(size_t)p*n+q];
+    if(apq==0) continue;
+    app=c[(size_t)p*n+p];
+    aqq=c[(size_t)q*n+q];
+    theta=(aqq-app)/(2*apq);     /* Rotation cancelling c[p,q] */
+    t=((theta>=0)?1:-1)/(fabs(theta)+sqrt(theta*theta+1));
+    cs=1/sqrt(t*t+1);
+    sn=t*cs;
+    tau=sn/(1+cs);
+    c[(size_t)p*n+p]=app-t*apq;
+    c[(size_t)q*n+q]=aqq+t*apq;
+    c[(size_t)p*n+q]=c[(size_t)q*n+p]=0;
+    for(i=0;i<n;i++)
+    {
+     if((i!=p)&&(i!=q))
+     {
+      aip=c[(size_t)i*n+p];
+      aiq=c[(size_t)i*n+q];
+      c[(size_t)i*n+p]=c[(size_t)p*n+i]=aip-sn*(aiq+tau*aip);
+      c[(size_t)i*n+q]=c[(size_t)q*n+i]=aiq+sn*(aip-tau*aiq);
+     }
+     aip=f[(size_t)i*n+p];         /* V:=V.R */
+     aiq=f[(size_t)i*n+q];
+     f[(size_t)i*n+p]=aip-sn*(aiq+tau*aip);
+     f[(size_t)i*n+q]=aiq+sn*(aip-tau*aiq);
+    }
+   }
+ }
+
+ lmax=0;
+ for(i=0;i<n;i++)
+  if(c[(size_t)i*n+i]>lmax) lmax=c[(size_t)i*n+i];
+ for(q=0;q<n;q++)               /* Scale column q by sqrt(lambda_q) */
+ {
+  t=c[(size_t)q*n+q];
+  if(t<-1e-9*lmax)
+   return 0;
+  t=(t>0)?sqrt(t):0;
+  for(i=0;i<n;i++)
+   f[(size_t)i*n+q]*=t;
+ }
+ return 1;
+}
+
+/****************************************************/
+/* Read an array of reals (in index order) into tab */
+/****************************************************/
+static void mv_getarr(XPRMarray arr,double *tab)
+{
+ XPRMalltypes v;
+ int indices[2];
+
+ if(!mm->getfirstarrentry(arr,indices))
+  do
+  {
+   mm->getarrval(arr,indices,&v);
+   *(tab++)=v.real;
+  } while(!mm->getnextarrentry(arr,indices));
+}
+
+/******************************************************************/
+/* Setup the distribution from the covariance array (& the mean)  */
+/* Returns 0 if the matrix is not symmetric positive semidefinite */
+/******************************************************************/
+static int mv_build(XPRMcontext ctx,s_mvnorm *mv,XPRMarray marr,
+                XPRMarray carr)
+{
+ double *c,tol,s;
+ int n,i,j,rts;
+
+ n=mv->n;
+ if((c=malloc((size_t)n*n*sizeof(double)))==NULL)
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return 0;
+ }
+ mv_getarr(carr,c);
+ if(marr!=NULL)
+  mv_getarr(marr,mv->mu);
+ else
+  memset(mv->mu,0,n*sizeof(double));
+
+ tol=0;
+ for(i=0;i<n;i++)
+ {
+  if(!(c[(size_t)i*n+i]>=0)||(c[(size_t)i*n+i]>1e300))
+  {
+   free(c);
+   return 0;
+  }
+  if(c[(size_t)i*n+i]>tol) tol=c[(size_t)i*n+i];
+ }
+ for(i=0;i<n;i++)               /* Check symmetry */
+  for(j=0;j<i;j++)
+  {
+   s=c[(size_t)i*n+j]-c[(size_t)j*n+i];
+   if(!(fabs(s)<=1e-9*tol))
+   {
+    free(c);
+    return 0;
+   }
+   c[(size_t)i*n+j]=c[(size_t)j*n+i]=c[(size_t)i*n+j]-0.5*s;
+  }
+
+ if(mv_cholesky(c,mv->f,n,n*1e-14*tol))
+ {
+  mv->tri=1;
+  rts=1;
+ }
+ else
+ {
+  mv->tri=0;
+  rts=mv_eigen(c,mv->f,n);
+ }
+ free(c);
+ return rts;
+}
+
+/*******************************************************/
+/* mvnormal(C) & mvnormal(M,C): distribution with mean */
+/* M (0 if omitted) and covariance matrix C            */
+/*******************************************************/
+static int mv_new(XPRMcontext ctx,s_rndctx *rndctx,XPRMarray marr,
+                XPRMarray carr)
 {
+ XPRMset sets[2];
+ s_mvnorm *mv;
  int n;
 
- n=XPRM_TOP_ST(ctx)->integer;
- if(n<=0)
-  return rnd_math_error(ctx,"chisquare");
+ if((carr==NULL)||(mm->getarrdim(carr)!=2))
+  n=0;
  else
  {
-  XPRM_TOP_ST(ctx)->real=chisquare(libctx,n);
+  mm->getarrsets(carr,sets);
+  n=mm->getsetsize(sets[0]);
+  if((mm->getsetsize(sets[1])!=n)||
+     ((marr!=NULL)&&((mm->getarrdim(marr)!=1)||(mm->getarrsize(marr)!=n))))
+   n=0;
+ }
+ if(n<1)
+ {
+  mm->dispmsg(ctx,"RANDOM: invalid array for `mvnormal'.\n");
+  return XPRM_RT_ERROR;
+ }
+ else
+ if((mv=mv_create(ctx,rndctx,NULL,0))==NULL)
+  return XPRM_RT_ERROR;
+ else
+ if(!mv_alloc(ctx,mv,n))
+ {
+  mv_delete(ctx,rndctx,mv,0);
+  return XPRM_RT_ERROR;
+ }
+ else
+ if(!mv_build(ctx,mv,marr,carr))
+ {
+  mv_delete(ctx,rndctx,mv,0);
+  return rnd_math_error(ctx,"mvnormal");
+ }
+ else
+ {
+  XPRM_PUSH_REF(ctx,mv);
   return XPRM_RT_OK;
  }
 }
 
-/* =========================================== 
- * Returns a student-t distributed real number.
- * NOTE: use n > 0
- * ===========================================
+static int mv_new1(XPRMcontext ctx,void *libctx)
+{
+ XPRMarray carr;
+
+ carr=XPRM_POP_REF(ctx);
+ return mv_new(ctx,libctx,NULL,carr);
+}
+
+static int mv_new2(XPRMcontext ctx,void *libctx)
+{
+ XPRMarray marr,carr;
+
+ marr=XPRM_POP_REF(ctx);
+ carr=XPRM_POP_REF(ctx);
+ return mv_new(ctx,libctx,marr,carr);
+}
+
+/*****************************************************/
+/* Generate nb samples into x (z: work space). Both  */
+/* blocks are stored by component: x[i*nb+k] is the  */
+/* component i of sample k                           */
+/*****************************************************/
+static void mv_draw(s_rndctx *rndctx,s_mvnorm *mv,int nb,double *z,
+                double *x)
+{
+ const double *fi,*zj;
+ double *xi,fij;
+ int n,i,j,k,jmax;
+
+ n=mv->n;
+ for(k=0;k<nb*n;k++)
+  z[k]=normal(rndctx,0,1);
+ for(i=0;i<n;i++)
+ {
+  fi=mv->f+(size_t)i*n;
+  xi=x+(size_t)i*nb;
+  for(k=0;k<nb;k++)
+   xi[k]=mv->mu[i];
+  jmax=mv->tri?i+1:n;
+  for(j=0,zj=z;j<jmax;j++,zj+=nb)
+   if((fij=fi[j])!=0)
+    for(k=0;k<nb;k++)
+     xi[k]+=fij*zj[k];
+ }
+}
+
+/****************************************************/
+static int mv_fill(XPRMcontext ctx,void *libctx)
+{
+ XPRMarray arr;
+ XPRMset sets[2];
+ s_mvnorm *mv;
+ double *z,*x;
+ int indices[2];
+ int n,dim,nbs,nb,ns,k,kx,done;
+
+ arr=XPRM_POP_REF(ctx);
+ mv=XPRM_POP_REF(ctx);
+ if((mv==NULL)||(mv->n<1))
+  return rnd_math_error(ctx,"fillrandom");
+ else
+ if((arr==NULL)||(mm->getarrsize(arr)<1))
+  return XPRM_RT_OK;
+
+ n=mv->n;
+ dim=mm->getarrdim(arr);
+ if(dim<=2)
+  mm->getarrsets(arr,sets);
+ if((dim>2)||(mm->getsetsize(sets[dim-1])!=n))
+ {
+  mm->dispmsg(ctx,"RANDOM: invalid array for `fillrandom'.\n");
+  return XPRM_RT_ERROR;
+ }
+ nbs=MV_BLOCK/n;                /* Samples per block */
+ if(nbs<1) nbs=1;
+ if((z=malloc(2*(size_t)nbs*n*sizeof(double)))==NULL)
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return XPRM_RT_ERROR;
+ }
+ x=z+(size_t)nbs*n;
+ nb=mm->getarrsize(arr)/n;      /* Total number of samples */
+ done=mm->getfirstarrentry(arr,indices);
+ for(k=0;(k<nb)&&!done;k+=nbs)
+ {
+  ns=(nb-k<nbs)?nb-k:nbs;
+  mv_draw(libctx,mv,ns,z,x);
+  for(kx=0;(kx<ns*n)&&!done;kx++)
+  {
+   mm->setarrvalreal(ctx,arr,indices,x[(kx%n)*ns+kx/n]);
+   done=mm->getnextarrentry(arr,indices);
+  }
+ }
+ free(z);
+ return XPRM_RT_OK;
+}
+
+/******** Sampling designs ********/
+
+/* ====================================================================
+ * Designs of n points in [0,1)^d, one point per row of a 2-dimensional
+ * array (the first n rows and d columns of the array are used):
+ *  - Latin hypercube: for each dimension the n points are in distinct
+ *    intervals [k/n,(k+1)/n) (random permutation of the intervals)
+ *  - Stratified: one point in each of the k^d cells of a regular grid
+ *    (n=k^d rows are generated)
+ *  - Antithetic: each point u of an even row is followed by 1-u
+ * The design is built in C in a temporary table (permutations are
+ * computed in place with the Fisher-Yates shuffle) before being
+ * copied to the array.
+ * ====================================================================
  */
-static int rnd_student(XPRMcontext ctx,void *libctx)
+
+/*************************************************/
+/* Build the design into t (n x d, column major) */
+/*************************************************/
+static void smp_build(s_rndctx *rndctx,int kind,int n,int d,int k,
+                double *t)
 {
- int n;
+ double v,*tj;
+ size_t i,r;
+ int j;
 
- n=XPRM_TOP_ST(ctx)->integer;
- if(n<=0)
-  return rnd_math_error(ctx,"student");
+ switch(kind)
+ {
+  case SMP_LHS:
+    for(j=0;j<d;j++)
+    {
+     tj=t+(size_t)j*n;
+     for(i=0;i<(size_t)n;i++)
+      tj[i]=(double)i;
+     for(i=n-1;i>0;i--)         /* Shuffle the column */
+     {
+      r=(size_t)(RANDOM*(i+1));
+      v=tj[i];
+      tj[i]=tj[r];
+      tj[r]=v;
+     }
+     for(i=0;i<(size_t)n;i++)
+      tj[i]=(tj[i]+RANDOM)/n;
+    }
+    break;
+  case SMP_STRAT:
+    for(i=0;i<(size_t)n;i++)
+     for(j=d-1,r=i;j>=0;j--,r/=k)       /* Digits of i in base k */
+      t[(size_t)j*n+i]=((double)(r%k)+RANDOM)/k;
+    break;
+  case SMP_ANTI:
+    for(i=0;i<(size_t)n;i++)
+     for(j=0;j<d;j++)
+      t[(size_t)j*n+i]=(i&1)?1-t[(size_t)j*n+i-1]:RANDOM;
+    break;
+ }
+}
+
+/*********************************************/
+/* Common routine for the sampling designs:  */
+/* parameters are (A,n,d) or (A,k,d)         */
+/*********************************************/
+static int smp_fill(XPRMcontext ctx,void *libctx,int kind,const char *name)
+{
+ XPRMarray arr;
+ XPRMset sets[2];
+ double *t;
+ int indices[2];
+ int n,d,k,ncol,pos,done;
+
+ arr=XPRM_POP_REF(ctx);
+ n=k=XPRM_POP_INT(ctx);
+ d=XPRM_POP_INT(ctx);
+ if((n<1)||(d<1))
+  return rnd_math_error(ctx,name);
+ if(kind==SMP_STRAT)            /* n=k^d */
+ {
+  for(pos=1;pos<d;pos++)
+   if(n>INT_MAX/k)
+    return rnd_math_error(ctx,name);
+   else
+    n*=k;
+ }
+ if((arr==NULL)||(mm->getarrdim(arr)!=2))
+  ncol=0;
  else
  {
-  XPRM_TOP_ST(ctx)->real=normal(libctx,0.0,1.0)/sqrt(chisquare(libctx,n)/n);
-  return XPRM_RT_OK;
+  mm->getarrsets(arr,sets);
+  ncol=mm->getsetsize(sets[1]);
+  if(mm->getsetsize(sets[0])<n)
+   ncol=0;
  }
+ if(ncol<d)
+ {
+  mm->dispmsg(ctx,"RANDOM: invalid array for `%s'.\n",name);
+  return XPRM_RT_ERROR;
+ }
+ if((t=malloc((size_t)n*d*sizeof(double)))==NULL)
+ {
+  mm->dispmsg(ctx,"RANDOM: Out of memory.\n");
+  return XPRM_RT_ERROR;
+ }
+ smp_build(libctx,kind,n,d,k,t);
+
+ done=mm->getfirstarrentry(arr,indices);
+ for(pos=0;!done&&(pos/ncol<n);pos++)
+ {
+  if(pos%ncol<d)
+   mm->setarrvalreal(ctx,arr,indices,t[(size_t)(pos%ncol)*n+pos/ncol]);
+  done=mm->getnextarrentry(arr,indices);
+ }
+ free(t);
+ return XPRM_RT_OK;
+}
+
+static int rnd_lhsample(XPRMcontext ctx,void *libctx)
+{
+ return smp_fill(ctx,libctx,SMP_LHS,"lhsample");
+}
+
+static int rnd_stratsample(XPRMcontext ctx,void *libctx)
+{
+ return smp_fill(ctx,libctx,SMP_STRAT,"stratsample");
+}
+
+static int rnd_antisample(XPRMcontext ctx,void *libctx)
+{
+ return smp_fill(ctx,libctx,SMP_ANTI,"antisample");
 }
 
 /*************************************/